@@ -57,6 +57,7 @@ using brave_shields::features::kBraveAdblockCookieListDefault;
 using brave_shields::features::kBraveAdblockCosmeticFiltering;
 using brave_shields::features::kBraveAdblockCspRules;
 using brave_shields::features::kBraveAdblockDefault1pBlocking;
+using brave_shields::features::kBraveAdblockMergedSubscriptions;
 using brave_shields::features::kBraveDarkModeBlock;
 using brave_shields::features::kBraveDomainBlock;
 using brave_shields::features::kBraveDomainBlock1PES;
@@ -104,6 +105,12 @@ constexpr char kBraveAdblockDefault1pBlockingDescription[] =
     "Allow Brave Shields to block first-party network requests in Standard "
     "blocking mode";
 
+constexpr char kBraveAdblockMergedSubscriptionsName[] =
+    "Merge filter list subscriptions";
+constexpr char kBraveAdblockMergedSubscriptionsDescription[] =
+    "Match requests against all enabled filter list subscriptions with a "
+    "single combined engine";
+
 constexpr char kBraveAdsCustomNotificationsName[] =
     "Enable Brave Ads custom push notifications";
 constexpr char kBraveAdsCustomNotificationsDescription[] =
@@ -446,6 +453,10 @@ constexpr char kNavigatorConnectionAttributeDescription[] =
      flag_descriptions::kBraveAdblockDefault1pBlockingName,                 \
      flag_descriptions::kBraveAdblockDefault1pBlockingDescription, kOsAll,  \
      FEATURE_VALUE_TYPE(kBraveAdblockDefault1pBlocking)},                   \
+    {"brave-adblock-merged-subscriptions",                                  \
+     flag_descriptions::kBraveAdblockMergedSubscriptionsName,               \
+     flag_descriptions::kBraveAdblockMergedSubscriptionsDescription,        \
+     kOsAll, FEATURE_VALUE_TYPE(kBraveAdblockMergedSubscriptions)},         \
     {"brave-dark-mode-block",                                               \
      flag_descriptions::kBraveDarkModeBlockName,                            \
      flag_descriptions::kBraveDarkModeBlockDescription, kOsAll,             \
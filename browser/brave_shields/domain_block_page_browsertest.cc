@@ -320,6 +320,7 @@ IN_PROC_BROWSER_TEST_F(DomainBlockTest, NoThirdPartyInterstitial) {
   ASSERT_TRUE(InstallDefaultAdBlockExtension());
   ASSERT_TRUE(g_brave_browser_process->ad_block_custom_filters_service()
                   ->UpdateCustomFilters("||b.com^$third-party"));
+  WaitForAdBlockServiceThreads();
 
   GURL url = embedded_test_server()->GetURL("a.com", "/simple_link.html");
   SetCosmeticFilteringControlType(content_settings(), ControlType::BLOCK, url);
@@ -5,6 +5,7 @@
 
 #include "brave/browser/net/brave_ad_block_tp_network_delegate_helper.h"
 
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -13,6 +14,7 @@
 #include "base/base64url.h"
 #include "base/feature_list.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_util.h"
 #include "brave/browser/brave_browser_process.h"
 #include "brave/browser/brave_shields/brave_shields_web_contents_observer.h"
@@ -30,6 +32,7 @@
 #include "components/prefs/pref_service.h"
 #include "components/proxy_config/pref_proxy_config_tracker.h"
 #include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/storage_partition.h"
@@ -177,40 +180,18 @@ bool IsValidPrivateCDNDomain(GURL url) {
   return false;
 }
 
-// If `canonical_url` is specified, this will only check if the CNAME-uncloaked
-// response should be blocked. Otherwise, it will run the check for the
-// original request URL.
-EngineFlags ShouldBlockRequestOnTaskRunner(
-    std::shared_ptr<BraveRequestInfo> ctx,
-    EngineFlags previous_result,
-    absl::optional<GURL> canonical_url) {
-  if (!ctx->initiator_url.is_valid()) {
-    return previous_result;
-  }
-  const std::string source_host = ctx->initiator_url.host();
-
-  GURL url_to_check;
-  if (canonical_url.has_value()) {
-    url_to_check = *canonical_url;
-  } else {
-    url_to_check = ctx->request_url;
-  }
-
-  bool force_aggressive = SameDomainOrHost(
-      ctx->initiator_url,
+bool ShouldForceAggressiveBlocking(const GURL& initiator_url) {
+  return SameDomainOrHost(
+      initiator_url,
       url::Origin::CreateFromNormalizedTuple("https", "youtube.com", 80),
       net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+}
 
-  SCOPED_UMA_HISTOGRAM_TIMER("Brave.Adblock.ShouldBlockRequest");
-  g_brave_browser_process->ad_block_service()->ShouldStartRequest(
-      url_to_check, ctx->resource_type, source_host,
-      ctx->aggressive_blocking || force_aggressive,
-      &previous_result.did_match_rule, &previous_result.did_match_exception,
-      &previous_result.did_match_important, &ctx->adblock_replacement_url);
-
-  if (previous_result.did_match_important ||
-      (previous_result.did_match_rule &&
-       !previous_result.did_match_exception)) {
+// Updates `ctx` with the outcome of the adblock engine query in `result`.
+void ApplyEngineResult(std::shared_ptr<BraveRequestInfo> ctx,
+                       const EngineFlags& result) {
+  if (result.did_match_important ||
+      (result.did_match_rule && !result.did_match_exception)) {
     ctx->blocked_by = kAdBlocked;
   }
 
@@ -234,10 +215,69 @@ EngineFlags ShouldBlockRequestOnTaskRunner(
       ctx->blocked_by = kNotBlocked;
     }
   }
+}
+
+// Checks if the CNAME-uncloaked `canonical_url` of the request should be
+// blocked.
+EngineFlags ShouldBlockRequestOnTaskRunner(
+    std::shared_ptr<BraveRequestInfo> ctx,
+    EngineFlags previous_result,
+    const GURL& canonical_url) {
+  if (!ctx->initiator_url.is_valid()) {
+    return previous_result;
+  }
+  const std::string source_host = ctx->initiator_url.host();
+
+  SCOPED_UMA_HISTOGRAM_TIMER("Brave.Adblock.ShouldBlockRequest");
+  g_brave_browser_process->ad_block_service()->ShouldStartRequest(
+      canonical_url, ctx->resource_type, source_host,
+      ctx->aggressive_blocking ||
+          ShouldForceAggressiveBlocking(ctx->initiator_url),
+      &previous_result.did_match_rule, &previous_result.did_match_exception,
+      &previous_result.did_match_important, &ctx->adblock_replacement_url);
 
+  ApplyEngineResult(ctx, previous_result);
   return previous_result;
 }
 
+// Checks all requests in `ctxs`, which were all initiated by `source_host`,
+// with a single call into the adblock engines.
+std::vector<EngineFlags> ShouldBlockRequestsOnTaskRunner(
+    const std::string& source_host,
+    std::vector<std::shared_ptr<BraveRequestInfo>> ctxs) {
+  std::vector<brave_shields::AdBlockMatchRequest> requests;
+  requests.reserve(ctxs.size());
+  std::vector<brave_shields::AdBlockMatchRequest*> valid_requests;
+  for (const auto& ctx : ctxs) {
+    requests.emplace_back(ctx->request_url, ctx->resource_type,
+                          ctx->aggressive_blocking ||
+                              ShouldForceAggressiveBlocking(ctx->initiator_url));
+    requests.back().replacement_url = ctx->adblock_replacement_url;
+    if (ctx->initiator_url.is_valid()) {
+      valid_requests.push_back(&requests.back());
+    }
+  }
+
+  {
+    SCOPED_UMA_HISTOGRAM_TIMER("Brave.Adblock.ShouldBlockRequestBatch");
+    g_brave_browser_process->ad_block_service()->ShouldStartRequests(
+        source_host, valid_requests);
+  }
+
+  std::vector<EngineFlags> results(ctxs.size());
+  for (size_t i = 0; i < ctxs.size(); ++i) {
+    if (!ctxs[i]->initiator_url.is_valid()) {
+      continue;
+    }
+    results[i].did_match_rule = requests[i].did_match_rule;
+    results[i].did_match_exception = requests[i].did_match_exception;
+    results[i].did_match_important = requests[i].did_match_important;
+    ctxs[i]->adblock_replacement_url = requests[i].replacement_url;
+    ApplyEngineResult(ctxs[i], results[i]);
+  }
+  return results;
+}
+
 void OnShouldBlockRequestResult(
     bool then_check_uncloaked,
     scoped_refptr<base::SequencedTaskRunner> task_runner,
@@ -274,7 +314,7 @@ void UseCnameResult(scoped_refptr<base::SequencedTaskRunner> task_runner,
     task_runner->PostTaskAndReplyWithResult(
         FROM_HERE,
         base::BindOnce(&ShouldBlockRequestOnTaskRunner, ctx, previous_result,
-                       absl::make_optional<GURL>(canonical_url)),
+                       canonical_url),
         base::BindOnce(&OnShouldBlockRequestResult, false, task_runner,
                        next_callback, ctx));
   } else {
@@ -282,6 +322,77 @@ void UseCnameResult(scoped_refptr<base::SequencedTaskRunner> task_runner,
   }
 }
 
+// A request waiting to be matched together with the other requests that
+// arrived in the same burst.
+struct PendingAdBlockRequest {
+  ResponseCallback next_callback;
+  std::shared_ptr<BraveRequestInfo> ctx;
+  bool should_check_uncloaked;
+};
+
+// Only accessed on the adblock task runner.
+std::vector<PendingAdBlockRequest>& GetPendingAdBlockRequests() {
+  static base::NoDestructor<std::vector<PendingAdBlockRequest>> pending;
+  return *pending;
+}
+
+void OnShouldBlockRequestsResult(
+    scoped_refptr<base::SequencedTaskRunner> task_runner,
+    std::vector<PendingAdBlockRequest> requests,
+    std::vector<EngineFlags> results) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  DCHECK_EQ(requests.size(), results.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    OnShouldBlockRequestResult(requests[i].should_check_uncloaked, task_runner,
+                               requests[i].next_callback, requests[i].ctx,
+                               results[i]);
+  }
+}
+
+// Matches all requests queued since the last call, one engine call per
+// initiating host, so a page firing a burst of subresource requests crosses
+// into the engines once instead of once per request.
+void ShouldBlockPendingRequestsOnTaskRunner(
+    scoped_refptr<base::SequencedTaskRunner> task_runner) {
+  DCHECK(task_runner->RunsTasksInCurrentSequence());
+  std::vector<PendingAdBlockRequest> pending;
+  pending.swap(GetPendingAdBlockRequests());
+
+  std::map<std::string, std::vector<PendingAdBlockRequest>> requests_by_host;
+  for (auto& request : pending) {
+    const std::string source_host = request.ctx->initiator_url.host();
+    requests_by_host[source_host].push_back(std::move(request));
+  }
+
+  for (auto& host_requests : requests_by_host) {
+    std::vector<std::shared_ptr<BraveRequestInfo>> ctxs;
+    for (const auto& request : host_requests.second) {
+      ctxs.push_back(request.ctx);
+    }
+    std::vector<EngineFlags> results =
+        ShouldBlockRequestsOnTaskRunner(host_requests.first, std::move(ctxs));
+    content::GetUIThreadTaskRunner({})->PostTask(
+        FROM_HERE,
+        base::BindOnce(&OnShouldBlockRequestsResult, task_runner,
+                       std::move(host_requests.second), std::move(results)));
+  }
+}
+
+// Queues the request on the adblock task runner. Requests posted before the
+// queue gets matched are checked together.
+void EnqueueRequestOnTaskRunner(
+    scoped_refptr<base::SequencedTaskRunner> task_runner,
+    PendingAdBlockRequest request) {
+  DCHECK(task_runner->RunsTasksInCurrentSequence());
+  std::vector<PendingAdBlockRequest>& pending = GetPendingAdBlockRequests();
+  if (pending.empty()) {
+    task_runner->PostTask(
+        FROM_HERE,
+        base::BindOnce(&ShouldBlockPendingRequestsOnTaskRunner, task_runner));
+  }
+  pending.push_back(std::move(request));
+}
+
 // If only particular types of network traffic are being proxied, or if no
 // proxy is configured, it should be safe to continue making unproxied DNS
 // queries. However, in SingleProxy mode all types of network traffic should go
@@ -342,9 +453,6 @@ void OnBeforeURLRequestAdBlockTP(const ResponseCallback& next_callback,
   DCHECK(!ctx->request_url.is_empty());
   DCHECK(!ctx->initiator_url.is_empty());
 
-  scoped_refptr<base::SequencedTaskRunner> task_runner =
-      g_brave_browser_process->ad_block_service()->GetTaskRunner();
-
   SecureDnsConfig secure_dns_config =
       SystemNetworkContextManager::GetStubResolverConfigReader()
           ->GetSecureDnsConfiguration(false);
@@ -373,12 +481,13 @@ void OnBeforeURLRequestAdBlockTP(const ResponseCallback& next_callback,
     should_check_uncloaked = false;
   }
 
-  task_runner->PostTaskAndReplyWithResult(
+  scoped_refptr<base::SequencedTaskRunner> task_runner =
+      g_brave_browser_process->ad_block_service()->GetTaskRunner();
+  task_runner->PostTask(
       FROM_HERE,
-      base::BindOnce(&ShouldBlockRequestOnTaskRunner, ctx, EngineFlags(),
-                     absl::nullopt),
-      base::BindOnce(&OnShouldBlockRequestResult, should_check_uncloaked,
-                     task_runner, next_callback, ctx));
+      base::BindOnce(
+          &EnqueueRequestOnTaskRunner, task_runner,
+          PendingAdBlockRequest{next_callback, ctx, should_check_uncloaked}));
 }
 
 int OnBeforeURLRequest_AdBlockTPPreWork(const ResponseCallback& next_callback,
@@ -8,6 +8,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/path_service.h"
 #include "base/threading/thread_task_runner_handle.h"
@@ -221,6 +222,40 @@ TEST_F(BraveAdBlockTPNetworkDelegateHelperTest, SimpleBlocking) {
   EXPECT_EQ(0ULL, host_resolver_->num_resolve());
 }
 
+TEST_F(BraveAdBlockTPNetworkDelegateHelperTest, BatchedBlocking) {
+  ResetAdblockInstance(g_brave_browser_process->ad_block_service(),
+                       "||brave.com/test.txt\n||example.com/ad.js", "", false);
+
+  std::vector<std::shared_ptr<brave::BraveRequestInfo>> requests;
+  for (const char* url : {"https://brave.com/test.txt", "https://brave.com/ok",
+                          "https://example.com/ad.js"}) {
+    auto request_info = std::make_shared<brave::BraveRequestInfo>(GURL(url));
+    request_info->request_identifier = requests.size() + 1;
+    request_info->resource_type = blink::mojom::ResourceType::kScript;
+    request_info->initiator_url = GURL("https://brave.com");
+    requests.push_back(request_info);
+  }
+  auto other_tab_request = std::make_shared<brave::BraveRequestInfo>(
+      GURL("https://example.com/ad.js"));
+  other_tab_request->request_identifier = requests.size() + 1;
+  other_tab_request->resource_type = blink::mojom::ResourceType::kScript;
+  other_tab_request->initiator_url = GURL("https://example.net");
+  requests.push_back(other_tab_request);
+
+  // Requests queued before the adblock task runner gets to run are matched
+  // together.
+  for (const auto& request_info : requests) {
+    EXPECT_EQ(net::ERR_IO_PENDING, OnBeforeURLRequest_AdBlockTPPreWork(
+                                       base::DoNothing(), request_info));
+  }
+  task_environment_.RunUntilIdle();
+
+  EXPECT_EQ(requests[0]->blocked_by, brave::kAdBlocked);
+  EXPECT_EQ(requests[1]->blocked_by, brave::kNotBlocked);
+  EXPECT_EQ(requests[2]->blocked_by, brave::kAdBlocked);
+  EXPECT_EQ(requests[3]->blocked_by, brave::kAdBlocked);
+}
+
 TEST_F(BraveAdBlockTPNetworkDelegateHelperTest, RedirectUrl) {
   ResetAdblockInstance(
       g_brave_browser_process->ad_block_service(),
@@ -6,6 +6,7 @@
 #include <assert.h>
 #include <cstring>
 #include <iostream>
+#include <vector>
 #include "wrapper.h"
 
 size_t num_passed = 0;
@@ -243,6 +244,67 @@ void TestException() {
         "image");
 }
 
+void TestMatchBatch() {
+  adblock::Engine engine(
+      "-advertisement-icon$third-party\n"
+      "-important-icon$important\n"
+      "-advertisement-$redirect=test\n"
+      "@@-advertisement-icon-good\n");
+  engine.addResource("test", "application/javascript", "YWxlcnQoMSk=");
+
+  std::vector<adblock::MatchRequest> requests(5);
+  requests[0] = {"http://example.com/-advertisement-icon", "example.com", true,
+                 C_RequestType_Image};
+  requests[1] = {"http://example.com/-advertisement-icon", "example.com",
+                 false, C_RequestType_Image};
+  requests[2] = {"http://example.com/-important-icon", "example.com", false,
+                 C_RequestType_Image};
+  requests[3] = {"http://example.com/-advertisement-icon-good", "example.com",
+                 true, C_RequestType_Image};
+  requests[4] = {"http://example.com/-advertisement-script", "example.com",
+                 false, C_RequestType_Script};
+  std::vector<adblock::MatchResult> results(requests.size());
+  engine.matchesBatch("brianbondy.com", requests, &results);
+
+  std::cout << "Batch match... ";
+  Assert(results[0].did_match_rule && !results[0].did_match_exception,
+         "Third-party rule should match");
+  Assert(!results[1].did_match_rule, "First-party request should not match");
+  Assert(results[2].did_match_rule && results[2].did_match_important,
+         "Important rule should match");
+  Assert(results[3].did_match_exception, "Exception should match");
+  Assert(results[4].redirect ==
+             "data:application/javascript;base64,YWxlcnQoMSk=",
+         "Redirect should be returned");
+  std::cout << "Passed!" << std::endl;
+  num_passed++;
+}
+
+void TestAddFilter() {
+  adblock::Engine engine("*banner.png\n");
+  Check(false, false, false, "", "Before adding a filter", &engine,
+        "http://example.com/-advertisement-icon", "example.com", "example.com",
+        false, "image");
+
+  Assert(engine.addFilter("-advertisement-icon"),
+         "Network filter should be added");
+  Check(true, false, false, "", "After adding a filter", &engine,
+        "http://example.com/-advertisement-icon", "example.com", "example.com",
+        false, "image");
+
+  Assert(engine.addFilter("@@-advertisement-icon-good"),
+         "Exception filter should be added");
+  Check(true, true, false, "", "After adding an exception", &engine,
+        "http://example.com/-advertisement-icon-good", "example.com",
+        "example.com", false, "image");
+
+  Assert(!engine.addFilter("example.com##.ads"),
+         "Cosmetic filter can't be added incrementally");
+  Check(true, false, false, "", "Existing filters are kept", &engine,
+        "http://example.com/ad_banner.png", "example.com", "example.com", false,
+        "image");
+}
+
 void TestClassId() {
   adblock::Engine engine(
       "###element\n"
@@ -433,6 +495,8 @@ int main() {
   TestThirdParty();
   TestImportant();
   TestException();
+  TestMatchBatch();
+  TestAddFilter();
   TestClassId();
   TestUrlCosmetics();
   TestSubdomainUrlCosmetics();
@@ -61,6 +61,46 @@ void engine_match(struct C_Engine* engine,
                   bool* did_match_important,
                   char** redirect);
 
+/**
+ * Request types understood by the engine. Passing them by value avoids
+ * building a string for every request on the C++ side.
+ */
+typedef enum {
+  C_RequestType_MainFrame,
+  C_RequestType_SubFrame,
+  C_RequestType_Stylesheet,
+  C_RequestType_Script,
+  C_RequestType_Image,
+  C_RequestType_Font,
+  C_RequestType_Other,
+  C_RequestType_Object,
+  C_RequestType_Media,
+  C_RequestType_Xhr,
+  C_RequestType_Ping,
+  C_RequestType_Unknown,
+} C_RequestType;
+
+/**
+ * Checks a batch of `requests_size` urls from the same `tab_host` against the
+ * specified `Engine`.
+ *
+ * Every array holds `requests_size` elements. Block results are used both as
+ * inputs and outputs, exactly like for `engine_match`. Each `redirects` element
+ * is set to null or to a string that must be destroyed with
+ * `c_char_buffer_destroy`.
+ */
+void engine_match_batch(struct C_Engine* engine,
+                        const char* tab_host,
+                        size_t requests_size,
+                        const char* const* urls,
+                        const char* const* hosts,
+                        const bool* third_party,
+                        const C_RequestType* request_types,
+                        bool* did_match_rule,
+                        bool* did_match_exception,
+                        bool* did_match_important,
+                        char** redirects);
+
 /**
  * Returns any CSP directives that should be added to a subdocument or document
  * request's response headers.
@@ -72,6 +112,15 @@ char* engine_get_csp_directives(struct C_Engine* engine,
                                 bool third_party,
                                 const char* resource_type);
 
+/**
+ * Adds a single network filter to an existing engine.
+ *
+ * Returns false if the filter could not be added incrementally, e.g. because
+ * it is a cosmetic filter, a `$badfilter` or can't be parsed. The engine has
+ * to be rebuilt from the full list in that case.
+ */
+bool engine_add_filter(struct C_Engine* engine, const char* filter);
+
 /**
  * Adds a tag to the engine for consideration
  */
@@ -7,7 +7,7 @@ use std::ffi::CStr;
 use std::ffi::CString;
 use std::os::raw::c_char;
 use std::string::String;
-use adblock::lists::ParseOptions;
+use adblock::lists::{parse_filter, ParseOptions, ParsedFilter};
 
 /// An external callback that receives a hostname and two out-parameters for start and end
 /// position. The callback should fill the start and end positions with the start and end indices
@@ -129,6 +129,103 @@ pub unsafe extern "C" fn engine_match(
     };
 }
 
+/// Request types understood by the engine. Passing them by value avoids building a string for
+/// every request on the C++ side.
+#[repr(C)]
+#[derive(Clone, Copy)]
+pub enum RequestType {
+    MainFrame,
+    SubFrame,
+    Stylesheet,
+    Script,
+    Image,
+    Font,
+    Other,
+    Object,
+    Media,
+    Xhr,
+    Ping,
+    Unknown,
+}
+
+impl RequestType {
+    fn as_str(self) -> &'static str {
+        match self {
+            RequestType::MainFrame => "main_frame",
+            RequestType::SubFrame => "sub_frame",
+            RequestType::Stylesheet => "stylesheet",
+            RequestType::Script => "script",
+            RequestType::Image => "image",
+            RequestType::Font => "font",
+            RequestType::Other => "other",
+            RequestType::Object => "object",
+            RequestType::Media => "media",
+            RequestType::Xhr => "xhr",
+            RequestType::Ping => "ping",
+            RequestType::Unknown => "",
+        }
+    }
+}
+
+/// Checks a batch of `requests_size` urls from the same `tab_host` against the specified `Engine`.
+///
+/// Every array holds `requests_size` elements. Block results are used both as inputs and outputs,
+/// exactly like for `engine_match`. Each `redirects` element is set to null or to a string that
+/// must be destroyed with `c_char_buffer_destroy`.
+#[no_mangle]
+pub unsafe extern "C" fn engine_match_batch(
+    engine: *mut Engine,
+    tab_host: *const c_char,
+    requests_size: size_t,
+    urls: *const *const c_char,
+    hosts: *const *const c_char,
+    third_party: *const bool,
+    request_types: *const RequestType,
+    did_match_rule: *mut bool,
+    did_match_exception: *mut bool,
+    did_match_important: *mut bool,
+    redirects: *mut *mut c_char,
+) {
+    let tab_host = CStr::from_ptr(tab_host).to_str().unwrap();
+    let urls = std::slice::from_raw_parts(urls, requests_size);
+    let hosts = std::slice::from_raw_parts(hosts, requests_size);
+    let third_party = std::slice::from_raw_parts(third_party, requests_size);
+    let request_types = std::slice::from_raw_parts(request_types, requests_size);
+    let did_match_rule = std::slice::from_raw_parts_mut(did_match_rule, requests_size);
+    let did_match_exception = std::slice::from_raw_parts_mut(did_match_exception, requests_size);
+    let did_match_important = std::slice::from_raw_parts_mut(did_match_important, requests_size);
+    let redirects = std::slice::from_raw_parts_mut(redirects, requests_size);
+    assert!(!engine.is_null());
+    let engine = Box::leak(Box::from_raw(engine));
+    for index in 0..requests_size {
+        let url = CStr::from_ptr(urls[index]).to_str().unwrap();
+        let host = CStr::from_ptr(hosts[index]).to_str().unwrap();
+        let blocker_result = engine.check_network_urls_with_hostnames_subset(
+            url,
+            host,
+            tab_host,
+            request_types[index].as_str(),
+            Some(third_party[index]),
+            did_match_rule[index] || did_match_exception[index],
+            !did_match_exception[index],
+        );
+        did_match_rule[index] |= blocker_result.matched;
+        did_match_exception[index] |= blocker_result.exception.is_some();
+        did_match_important[index] |= blocker_result.important;
+        redirects[index] = match blocker_result.redirect {
+            Some(Redirection::Resource(x)) => match CString::new(x) {
+                Ok(y) => y.into_raw(),
+                _ => ptr::null_mut(),
+            },
+            Some(Redirection::Url(x)) => match CString::new(x) {
+                Ok(y) => y.into_raw(),
+                _ => ptr::null_mut(),
+            },
+            None => ptr::null_mut(),
+        };
+    }
+}
+
 /// Returns any CSP directives that should be added to a subdocument or document request's response
 /// headers.
 #[no_mangle]
@@ -161,6 +258,24 @@ pub unsafe extern "C" fn engine_get_csp_directives(
     }
 }
 
+/// Adds a single network filter to an existing engine.
+///
+/// Returns false if the filter could not be added incrementally, e.g. because
+/// it is a cosmetic filter, a `$badfilter` or can't be parsed. The engine has
+/// to be rebuilt from the full list in that case.
+#[no_mangle]
+pub unsafe extern "C" fn engine_add_filter(engine: *mut Engine, filter: *const c_char) -> bool {
+    let filter = CStr::from_ptr(filter).to_str().unwrap();
+    assert!(!engine.is_null());
+    let engine = Box::leak(Box::from_raw(engine));
+    match parse_filter(filter, false, ParseOptions::default()) {
+        Ok(ParsedFilter::Network(network_filter)) => {
+            engine.blocker.filter_add(network_filter).is_ok()
+        }
+        _ => false,
+    }
+}
+
 /// Adds a tag to the engine for consideration
 #[no_mangle]
 pub unsafe extern "C" fn engine_add_tag(engine: *mut Engine, tag: *const c_char) {
@@ -72,6 +72,50 @@ void Engine::matches(const std::string& url,
   }
 }
 
+void Engine::matchesBatch(const std::string& tab_host,
+                          const std::vector<MatchRequest>& requests,
+                          std::vector<MatchResult>* results) {
+  const size_t size = requests.size();
+  if (!results || results->size() != size || size == 0) {
+    return;
+  }
+
+  std::vector<const char*> urls_raw(size);
+  std::vector<const char*> hosts_raw(size);
+  std::vector<RequestType> request_types(size);
+  // std::vector<bool> is not contiguous, so plain arrays are used for flags.
+  std::unique_ptr<bool[]> third_party(new bool[size]);
+  std::unique_ptr<bool[]> did_match_rule(new bool[size]);
+  std::unique_ptr<bool[]> did_match_exception(new bool[size]);
+  std::unique_ptr<bool[]> did_match_important(new bool[size]);
+  std::vector<char*> redirects_raw(size, nullptr);
+  for (size_t i = 0; i < size; i++) {
+    urls_raw[i] = requests[i].url.c_str();
+    hosts_raw[i] = requests[i].host.c_str();
+    request_types[i] = requests[i].request_type;
+    third_party[i] = requests[i].is_third_party;
+    did_match_rule[i] = (*results)[i].did_match_rule;
+    did_match_exception[i] = (*results)[i].did_match_exception;
+    did_match_important[i] = (*results)[i].did_match_important;
+  }
+
+  engine_match_batch(raw, tab_host.c_str(), size, urls_raw.data(),
+                     hosts_raw.data(), third_party.get(), request_types.data(),
+                     did_match_rule.get(), did_match_exception.get(),
+                     did_match_important.get(), redirects_raw.data());
+
+  for (size_t i = 0; i < size; i++) {
+    MatchResult& result = (*results)[i];
+    result.did_match_rule = did_match_rule[i];
+    result.did_match_exception = did_match_exception[i];
+    result.did_match_important = did_match_important[i];
+    if (redirects_raw[i]) {
+      result.redirect = redirects_raw[i];
+      c_char_buffer_destroy(redirects_raw[i]);
+    }
+  }
+}
+
 std::string Engine::getCspDirectives(const std::string& url,
                                      const std::string& host,
                                      const std::string& tab_host,
@@ -90,6 +134,10 @@ bool Engine::deserialize(const char* data, size_t data_size) {
   return engine_deserialize(raw, data, data_size);
 }
 
+bool Engine::addFilter(const std::string& filter) {
+  return engine_add_filter(raw, filter.c_str());
+}
+
 void Engine::addTag(const std::string& tag) {
   engine_add_tag(raw, tag.c_str());
 }
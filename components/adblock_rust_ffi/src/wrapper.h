@@ -34,6 +34,7 @@ extern "C" {
 namespace adblock {
 
 typedef C_DomainResolverCallback DomainResolverCallback;
+typedef C_RequestType RequestType;
 
 bool ADBLOCK_EXPORT SetDomainResolver(DomainResolverCallback resolver);
 
@@ -64,6 +65,20 @@ class ADBLOCK_EXPORT FilterList {
   static std::vector<FilterList> regional_list;
 };
 
+struct ADBLOCK_EXPORT MatchRequest {
+  std::string url;
+  std::string host;
+  bool is_third_party = false;
+  RequestType request_type = C_RequestType_Unknown;
+};
+
+struct ADBLOCK_EXPORT MatchResult {
+  bool did_match_rule = false;
+  bool did_match_exception = false;
+  bool did_match_important = false;
+  std::string redirect;
+};
+
 class ADBLOCK_EXPORT Engine {
  public:
   Engine();
@@ -79,12 +94,21 @@ class ADBLOCK_EXPORT Engine {
                bool* did_match_exception,
                bool* did_match_important,
                std::string* redirect);
+  // Matches all |requests| of |tab_host| in a single call into the engine.
+  // |results| must hold one entry per request and, like the flags passed to
+  // matches(), is used both as input and output.
+  void matchesBatch(const std::string& tab_host,
+                    const std::vector<MatchRequest>& requests,
+                    std::vector<MatchResult>* results);
   std::string getCspDirectives(const std::string& url,
                                const std::string& host,
                                const std::string& tab_host,
                                bool is_third_party,
                                const std::string& resource_type);
   bool deserialize(const char* data, size_t data_size);
+  // Adds one network filter to the live engine. Returns false if the filter
+  // can only be applied by rebuilding the engine from the whole list.
+  bool addFilter(const std::string& filter);
   void addTag(const std::string& tag);
   void addResource(const std::string& key,
                    const std::string& content_type,
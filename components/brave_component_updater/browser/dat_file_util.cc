@@ -44,4 +44,16 @@ std::string GetDATFileAsString(const base::FilePath& file_path) {
   return contents;
 }
 
+std::unique_ptr<base::MemoryMappedFile> MapDATFile(
+    const base::FilePath& file_path) {
+  auto dat_file = std::make_unique<base::MemoryMappedFile>();
+  if (!dat_file->Initialize(file_path) || dat_file->length() == 0) {
+    LOG(ERROR) << "MapDATFile: "
+               << "the dat file is not found or corrupted "
+               << file_path;
+    return nullptr;
+  }
+  return dat_file;
+}
+
 }  // namespace brave_component_updater
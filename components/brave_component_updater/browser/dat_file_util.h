@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
 
 namespace brave_component_updater {
 
@@ -20,34 +21,62 @@ using DATFileDataBuffer = std::vector<unsigned char>;
 void GetDATFileData(const base::FilePath& file_path, DATFileDataBuffer* buffer);
 std::string GetDATFileAsString(const base::FilePath& file_path);
 
+// Maps |file_path| read-only instead of copying it to the heap. The pages are
+// backed by the OS page cache, so every profile and process mapping the same
+// DAT file shares them. Returns nullptr if the file is missing or empty.
+std::unique_ptr<base::MemoryMappedFile> MapDATFile(
+    const base::FilePath& file_path);
+
+// The parsed client and the mapping it was parsed from. Clients that keep
+// pointers into their input have to keep the mapping alive as long as they
+// are used, the others can drop it right away.
 template <typename T>
 using LoadDATFileDataResult =
-    std::pair<std::unique_ptr<T>, brave_component_updater::DATFileDataBuffer>;
+    std::pair<std::unique_ptr<T>, std::unique_ptr<base::MemoryMappedFile>>;
 
 template <typename T>
 LoadDATFileDataResult<T> LoadDATFileData(const base::FilePath& dat_file_path) {
-  DATFileDataBuffer buffer;
-  GetDATFileData(dat_file_path, &buffer);
+  std::unique_ptr<base::MemoryMappedFile> dat_file = MapDATFile(dat_file_path);
   std::unique_ptr<T> client;
   client = std::make_unique<T>();
-  if (buffer.empty() ||
-      !client->deserialize(reinterpret_cast<char*>(&buffer.front()),
-                           buffer.size()))
+  if (!dat_file ||
+      !client->deserialize(reinterpret_cast<const char*>(dat_file->data()),
+                           dat_file->length()))
     client.reset();
-  return LoadDATFileDataResult<T>(std::move(client), std::move(buffer));
+  return LoadDATFileDataResult<T>(std::move(client), std::move(dat_file));
 }
 
 template <typename T>
 LoadDATFileDataResult<T> LoadRawFileData(const base::FilePath& dat_file_path) {
-  DATFileDataBuffer buffer;
-  GetDATFileData(dat_file_path, &buffer);
+  std::unique_ptr<base::MemoryMappedFile> dat_file = MapDATFile(dat_file_path);
   std::unique_ptr<T> client;
 
-  if (!buffer.empty())
-    client = std::make_unique<T>(reinterpret_cast<char*>(&buffer.front()),
-                                 buffer.size());
+  if (dat_file)
+    client = std::make_unique<T>(
+        reinterpret_cast<const char*>(dat_file->data()), dat_file->length());
 
-  return LoadDATFileDataResult<T>(std::move(client), std::move(buffer));
+  return LoadDATFileDataResult<T>(std::move(client), std::move(dat_file));
+}
+
+// The parsed client and the heap copy of the DAT file it was parsed from.
+template <typename T>
+using LoadWritableDATFileDataResult =
+    std::pair<std::unique_ptr<T>, DATFileDataBuffer>;
+
+// Like LoadDATFileData(), for clients which deserialize from a writable
+// buffer and so can't use the read-only mapping.
+template <typename T>
+LoadWritableDATFileDataResult<T> LoadWritableDATFileData(
+    const base::FilePath& dat_file_path) {
+  DATFileDataBuffer buffer;
+  GetDATFileData(dat_file_path, &buffer);
+  std::unique_ptr<T> client;
+  client = std::make_unique<T>();
+  if (buffer.empty() ||
+      !client->deserialize(reinterpret_cast<char*>(&buffer.front()),
+                           buffer.size()))
+    client.reset();
+  return LoadWritableDATFileDataResult<T>(std::move(client), std::move(buffer));
 }
 
 }  // namespace brave_component_updater
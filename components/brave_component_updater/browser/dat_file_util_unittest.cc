@@ -0,0 +1,111 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_component_updater {
+
+namespace {
+
+class FakeClient {
+ public:
+  FakeClient() = default;
+  FakeClient(const char* data, size_t data_size) : data_(data, data_size) {}
+
+  bool deserialize(const char* data, size_t data_size) {
+    data_.assign(data, data_size);
+    return data_ != "corrupted";
+  }
+
+  const std::string& data() const { return data_; }
+
+ private:
+  std::string data_;
+};
+
+// Deserializes from a writable buffer, like ExtensionWhitelistParser.
+class FakeWritableClient {
+ public:
+  bool deserialize(char* data, size_t data_size) {
+    data_.assign(data, data_size);
+    return data_ != "corrupted";
+  }
+
+  const std::string& data() const { return data_; }
+
+ private:
+  std::string data_;
+};
+
+}  // namespace
+
+class DATFileUtilTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  base::FilePath WriteDATFile(const std::string& contents) {
+    base::FilePath path = temp_dir_.GetPath().AppendASCII("rs-test.dat");
+    EXPECT_TRUE(base::WriteFile(path, contents));
+    return path;
+  }
+
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(DATFileUtilTest, LoadDATFileData) {
+  auto result = LoadDATFileData<FakeClient>(WriteDATFile("serialized"));
+  ASSERT_TRUE(result.first);
+  ASSERT_TRUE(result.second);
+  EXPECT_EQ("serialized", result.first->data());
+  EXPECT_EQ(10u, result.second->length());
+}
+
+TEST_F(DATFileUtilTest, LoadDATFileDataFailures) {
+  auto missing = LoadDATFileData<FakeClient>(
+      temp_dir_.GetPath().AppendASCII("does_not_exist"));
+  EXPECT_FALSE(missing.first);
+  EXPECT_FALSE(missing.second);
+
+  auto empty = LoadDATFileData<FakeClient>(WriteDATFile(""));
+  EXPECT_FALSE(empty.first);
+  EXPECT_FALSE(empty.second);
+
+  auto corrupted = LoadDATFileData<FakeClient>(WriteDATFile("corrupted"));
+  EXPECT_FALSE(corrupted.first);
+  EXPECT_TRUE(corrupted.second);
+}
+
+TEST_F(DATFileUtilTest, LoadRawFileData) {
+  auto result = LoadRawFileData<FakeClient>(WriteDATFile("||ads.example^"));
+  ASSERT_TRUE(result.first);
+  EXPECT_EQ("||ads.example^", result.first->data());
+
+  auto empty = LoadRawFileData<FakeClient>(WriteDATFile(""));
+  EXPECT_FALSE(empty.first);
+}
+
+TEST_F(DATFileUtilTest, LoadWritableDATFileData) {
+  auto result =
+      LoadWritableDATFileData<FakeWritableClient>(WriteDATFile("serialized"));
+  ASSERT_TRUE(result.first);
+  EXPECT_EQ("serialized", result.first->data());
+  EXPECT_EQ(10u, result.second.size());
+
+  auto empty = LoadWritableDATFileData<FakeWritableClient>(WriteDATFile(""));
+  EXPECT_FALSE(empty.first);
+  EXPECT_TRUE(empty.second.empty());
+
+  auto corrupted =
+      LoadWritableDATFileData<FakeWritableClient>(WriteDATFile("corrupted"));
+  EXPECT_FALSE(corrupted.first);
+}
+
+}  // namespace brave_component_updater
@@ -68,7 +68,8 @@ void ExtensionWhitelistService::OnComponentReady(
   base::PostTaskAndReplyWithResult(
       local_data_files_service()->GetTaskRunner().get(), FROM_HERE,
       base::BindOnce(
-          &brave_component_updater::LoadDATFileData<ExtensionWhitelistParser>,
+          &brave_component_updater::LoadWritableDATFileData<
+              ExtensionWhitelistParser>,
           dat_file_path),
       base::BindOnce(&ExtensionWhitelistService::OnGetDATFileData,
                      weak_factory_.GetWeakPtr()));
@@ -32,7 +32,8 @@ namespace brave_component_updater {
 class ExtensionWhitelistService : public LocalDataFilesObserver {
  public:
   using GetDATFileDataResult =
-      brave_component_updater::LoadDATFileDataResult<ExtensionWhitelistParser>;
+      brave_component_updater::LoadWritableDATFileDataResult<
+          ExtensionWhitelistParser>;
 
   explicit ExtensionWhitelistService(
       LocalDataFilesService* local_data_files_service,
@@ -16,11 +16,14 @@
 #include "base/json/json_reader.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/post_task.h"
 #include "base/task/thread_pool.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
@@ -100,16 +103,74 @@ std::string ResourceTypeToString(blink::mojom::ResourceType resource_type) {
   return filter_option;
 }
 
+void ApplyMatchResult(const brave_shields::AdBlockMatchCache::Result& result,
+                      brave_shields::AdBlockMatchRequest* request) {
+  request->did_match_rule = result.did_match_rule;
+  request->did_match_exception = result.did_match_exception;
+  request->did_match_important = result.did_match_important;
+  if (!result.redirect.empty()) {
+    request->replacement_url = result.redirect;
+  }
+}
+
+// A filter and its hash.
+using IndexedRule = std::pair<size_t, base::StringPiece>;
+
+// Returns the distinct filters of |rules| sorted by hash and then by text,
+// pointing into |rules|. Sets |has_collision| if two different filters share a
+// hash, as only the hashes are kept once the engine is built.
+std::vector<IndexedRule> IndexRules(base::StringPiece rules,
+                                    bool* has_collision) {
+  std::vector<IndexedRule> rule_index;
+  for (const auto& line : brave_shields::SplitFilterList(rules)) {
+    rule_index.emplace_back(base::StringPieceHash()(line), line);
+  }
+  std::sort(rule_index.begin(), rule_index.end());
+  rule_index.erase(std::unique(rule_index.begin(), rule_index.end()),
+                   rule_index.end());
+  *has_collision =
+      std::adjacent_find(rule_index.begin(), rule_index.end(),
+                         [](const IndexedRule& a, const IndexedRule& b) {
+                           return a.first == b.first;
+                         }) != rule_index.end();
+  return rule_index;
+}
+
 }  // namespace
 
 namespace brave_shields {
 
+AdBlockMatchRequest::AdBlockMatchRequest(
+    const GURL& url,
+    blink::mojom::ResourceType resource_type,
+    bool aggressive_blocking)
+    : url(url),
+      resource_type(resource_type),
+      aggressive_blocking(aggressive_blocking) {}
+
+AdBlockMatchRequest::AdBlockMatchRequest(const AdBlockMatchRequest&) = default;
+
+AdBlockMatchRequest::~AdBlockMatchRequest() = default;
+
+AdBlockBaseService::RebuildState::RebuildState(AdBlockBaseService* service)
+    : weak_factory(service) {}
+
+AdBlockBaseService::RebuildState::~RebuildState() = default;
+
 AdBlockBaseService::AdBlockBaseService(BraveComponent::Delegate* delegate)
     : BaseBraveShieldsService(delegate),
       ad_block_client_(new adblock::Engine()),
+      rebuild_state_(new RebuildState(this),
+                     base::OnTaskRunnerDeleter(GetTaskRunner())),
       weak_factory_(this) {}
 
 AdBlockBaseService::~AdBlockBaseService() {
+  // |rebuild_state_| is only deleted once the task runner gets to it, so a
+  // service deleted on the task runner drops the rebuilds in flight right
+  // away.
+  if (GetTaskRunner()->RunsTasksInCurrentSequence()) {
+    rebuild_state_->weak_factory.InvalidateWeakPtrs();
+  }
   GetTaskRunner()->DeleteSoon(FROM_HERE, ad_block_client_.release());
 }
 
@@ -133,10 +194,27 @@ void AdBlockBaseService::ShouldStartRequest(
       url,
       url::Origin::CreateFromNormalizedTuple("https", tab_host.c_str(), 80),
       INCLUDE_PRIVATE_REGISTRIES);
-  ad_block_client_->matches(url.spec(), url.host(), tab_host, is_third_party,
-                            ResourceTypeToString(resource_type), did_match_rule,
-                            did_match_exception, did_match_important,
-                            replacement_url);
+  const std::string cache_key = AdBlockMatchCache::MakeKey(
+      url, tab_host, resource_type, is_third_party, *did_match_rule,
+      *did_match_exception, *did_match_important);
+  AdBlockMatchCache::Result result;
+  if (!match_cache_.Get(cache_key, &result)) {
+    result.did_match_rule = *did_match_rule;
+    result.did_match_exception = *did_match_exception;
+    result.did_match_important = *did_match_important;
+    ad_block_client_->matches(url.spec(), url.host(), tab_host, is_third_party,
+                              ResourceTypeToString(resource_type),
+                              &result.did_match_rule,
+                              &result.did_match_exception,
+                              &result.did_match_important, &result.redirect);
+    match_cache_.Put(cache_key, result);
+  }
+  *did_match_rule = result.did_match_rule;
+  *did_match_exception = result.did_match_exception;
+  *did_match_important = result.did_match_important;
+  if (!result.redirect.empty() && replacement_url) {
+    *replacement_url = result.redirect;
+  }
 
   // LOG(ERROR) << "AdBlockBaseService::ShouldStartRequest(), host: "
   //  << tab_host
@@ -144,6 +222,69 @@ void AdBlockBaseService::ShouldStartRequest(
   //  << ", url.spec(): " << url.spec();
 }
 
+void AdBlockBaseService::ShouldStartRequests(
+    const std::string& tab_host,
+    const std::vector<AdBlockMatchRequest*>& requests) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+
+  // The eTLD+1 of the tab is the same for the whole batch.
+  const std::string tab_domain =
+      GetDomainAndRegistry(tab_host, INCLUDE_PRIVATE_REGISTRIES);
+
+  std::vector<AdBlockMatchRequest*> pending_requests;
+  std::vector<std::string> cache_keys;
+  std::vector<adblock::MatchRequest> match_requests;
+  std::vector<adblock::MatchResult> match_results;
+  for (AdBlockMatchRequest* request : requests) {
+    if (request->did_match_important) {
+      continue;
+    }
+    const bool is_third_party =
+        IsThirdPartyRequest(request->url, tab_host, tab_domain);
+    std::string cache_key = AdBlockMatchCache::MakeKey(
+        request->url, tab_host, request->resource_type, is_third_party,
+        request->did_match_rule, request->did_match_exception,
+        request->did_match_important);
+    AdBlockMatchCache::Result cached;
+    if (match_cache_.Get(cache_key, &cached)) {
+      ApplyMatchResult(cached, request);
+      continue;
+    }
+
+    adblock::MatchRequest match_request;
+    match_request.url = request->url.spec();
+    match_request.host = request->url.host();
+    match_request.is_third_party = is_third_party;
+    match_request.request_type =
+        ResourceTypeToRequestType(request->resource_type);
+    match_requests.push_back(std::move(match_request));
+
+    adblock::MatchResult match_result;
+    match_result.did_match_rule = request->did_match_rule;
+    match_result.did_match_exception = request->did_match_exception;
+    match_result.did_match_important = request->did_match_important;
+    match_results.push_back(std::move(match_result));
+
+    pending_requests.push_back(request);
+    cache_keys.push_back(std::move(cache_key));
+  }
+  if (pending_requests.empty()) {
+    return;
+  }
+
+  ad_block_client_->matchesBatch(tab_host, match_requests, &match_results);
+
+  for (size_t i = 0; i < pending_requests.size(); ++i) {
+    AdBlockMatchCache::Result result;
+    result.did_match_rule = match_results[i].did_match_rule;
+    result.did_match_exception = match_results[i].did_match_exception;
+    result.did_match_important = match_results[i].did_match_important;
+    result.redirect = std::move(match_results[i].redirect);
+    ApplyMatchResult(result, pending_requests[i]);
+    match_cache_.Put(cache_keys[i], result);
+  }
+}
+
 absl::optional<std::string> AdBlockBaseService::GetCspDirectives(
     const GURL& url,
     blink::mojom::ResourceType resource_type,
@@ -189,6 +330,7 @@ void AdBlockBaseService::EnableTag(const std::string& tag, bool enabled) {
       tags_.erase(it);
     }
   }
+  OnEngineChanged();
 }
 
 void AdBlockBaseService::AddResources(const std::string& resources) {
@@ -201,6 +343,7 @@ void AdBlockBaseService::AddResources(const std::string& resources) {
 
   ad_block_client_->addResources(resources);
   resources_ = resources;
+  OnEngineChanged();
 }
 
 bool AdBlockBaseService::TagExists(const std::string& tag) {
@@ -244,7 +387,7 @@ void AdBlockBaseService::GetDATFileData(const base::FilePath& dat_file_path,
 
 void AdBlockBaseService::OnGetDATFileData(base::OnceClosure callback,
                                           GetDATFileDataResult result) {
-  if (result.second.empty()) {
+  if (!result.second) {
     LOG(ERROR) << "Could not obtain ad block data";
     return;
   }
@@ -266,6 +409,101 @@ void AdBlockBaseService::UpdateAdBlockClient(
   ad_block_client_ = std::move(ad_block_client);
   AddKnownTagsToAdBlockInstance();
   AddKnownResourcesToAdBlockInstance();
+  rule_hashes_.clear();
+  OnEngineChanged();
+}
+
+void AdBlockBaseService::OnEngineChanged() {
+  match_cache_.Clear();
+  InvalidateAdBlockEngines();
+}
+
+base::WeakPtr<AdBlockBaseService> AdBlockBaseService::GetTaskRunnerWeakPtr() {
+  return rebuild_state_->weak_factory.GetWeakPtr();
+}
+
+void AdBlockBaseService::UpdateRules(std::string rules,
+                                     base::OnceClosure callback) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  bool has_collision = false;
+  const std::vector<IndexedRule> rule_index = IndexRules(rules, &has_collision);
+  std::vector<size_t> rule_hashes;
+  rule_hashes.reserve(rule_index.size());
+  for (const auto& rule : rule_index) {
+    if (rule_hashes.empty() || rule_hashes.back() != rule.first) {
+      rule_hashes.push_back(rule.first);
+    }
+  }
+
+  // Removing filters from a live engine isn't supported by adblock-rust, so
+  // only a pure addition of filters takes the incremental path. The live
+  // engine is also superseded by a rebuild which is still running. Only the
+  // hashes of the current filters are kept, so a list with colliding hashes
+  // can't be compared and is rebuilt.
+  if (rebuild_state_->is_rebuilding || has_collision || rule_hashes_.empty() ||
+      !base::IsStringUTF8(rules) ||
+      !std::includes(rule_hashes.begin(), rule_hashes.end(),
+                     rule_hashes_.begin(), rule_hashes_.end())) {
+    RebuildEngine(std::move(rules), std::move(rule_hashes),
+                  std::move(callback));
+    return;
+  }
+
+  bool changed = false;
+  for (const auto& rule : rule_index) {
+    if (std::binary_search(rule_hashes_.begin(), rule_hashes_.end(),
+                           rule.first)) {
+      continue;
+    }
+    if (!ad_block_client_->addFilter(std::string(rule.second))) {
+      RebuildEngine(std::move(rules), std::move(rule_hashes),
+                    std::move(callback));
+      return;
+    }
+    changed = true;
+  }
+  rule_hashes_ = std::move(rule_hashes);
+  if (changed) {
+    OnEngineChanged();
+  }
+  std::move(callback).Run();
+}
+
+void AdBlockBaseService::RebuildEngine(std::string rules,
+                                       std::vector<size_t> rule_hashes,
+                                       base::OnceClosure callback) {
+  // Compiling a large list takes long enough to stall request matching on the
+  // task runner, so the engine is built on the thread pool and only swapped
+  // in here.
+  rebuild_state_->is_rebuilding = true;
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(
+          [](const std::string& rules) {
+            return std::make_unique<adblock::Engine>(rules.data(),
+                                                     rules.size());
+          },
+          std::move(rules)),
+      base::BindOnce(&AdBlockBaseService::OnEngineRebuilt,
+                     rebuild_state_->weak_factory.GetWeakPtr(),
+                     ++rebuild_state_->generation, std::move(rule_hashes),
+                     std::move(callback)));
+}
+
+void AdBlockBaseService::OnEngineRebuilt(
+    uint64_t generation,
+    std::vector<size_t> rule_hashes,
+    base::OnceClosure callback,
+    std::unique_ptr<adblock::Engine> ad_block_client) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  // A later rebuild supersedes this one.
+  if (generation != rebuild_state_->generation) {
+    return;
+  }
+  rebuild_state_->is_rebuilding = false;
+  UpdateAdBlockClient(std::move(ad_block_client));
+  rule_hashes_ = std::move(rule_hashes);
+  std::move(callback).Run();
 }
 
 void AdBlockBaseService::AddKnownTagsToAdBlockInstance() {
@@ -285,15 +523,14 @@ void AdBlockBaseService::ResetForTest(const std::string& rules,
                                       const std::string& resources,
                                       bool include_redirect_urls) {
   DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
-  // This is temporary until adblock-rust supports incrementally adding
-  // filter rules to an existing instance. At which point the hack below
-  // will dissapear.
   ad_block_client_.reset(new adblock::Engine(rules, include_redirect_urls));
+  rule_hashes_.clear();
   AddKnownTagsToAdBlockInstance();
   if (!resources.empty()) {
     resources_ = resources;
   }
   AddKnownResourcesToAdBlockInstance();
+  OnEngineChanged();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -17,8 +17,10 @@
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
+#include "base/task/sequenced_task_runner.h"
 #include "base/values.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/ad_block_match_cache.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
 
@@ -34,6 +36,25 @@ class Engine;
 
 namespace brave_shields {
 
+// One request of a batch passed to ShouldStartRequests(). The match flags and
+// |replacement_url| are used both as inputs and outputs, like the out
+// parameters of ShouldStartRequest().
+struct AdBlockMatchRequest {
+  AdBlockMatchRequest(const GURL& url,
+                      blink::mojom::ResourceType resource_type,
+                      bool aggressive_blocking);
+  AdBlockMatchRequest(const AdBlockMatchRequest&);
+  ~AdBlockMatchRequest();
+
+  GURL url;
+  blink::mojom::ResourceType resource_type;
+  bool aggressive_blocking;
+  bool did_match_rule = false;
+  bool did_match_exception = false;
+  bool did_match_important = false;
+  std::string replacement_url;
+};
+
 // The base class of the brave shields service in charge of ad-block
 // checking and init.
 class AdBlockBaseService : public BaseBraveShieldsService {
@@ -52,6 +73,11 @@ class AdBlockBaseService : public BaseBraveShieldsService {
                           bool* did_match_exception,
                           bool* did_match_important,
                           std::string* replacement_url) override;
+  // Matches all |requests| made by |tab_host| with a single call into the
+  // engine. Requests that already matched an important rule are skipped.
+  virtual void ShouldStartRequests(
+      const std::string& tab_host,
+      const std::vector<AdBlockMatchRequest*>& requests);
   absl::optional<std::string> GetCspDirectives(
       const GURL& url,
       blink::mojom::ResourceType resource_type,
@@ -83,17 +109,60 @@ class AdBlockBaseService : public BaseBraveShieldsService {
   void ResetForTest(const std::string& rules,
                     const std::string& resources = "",
                     bool include_redirect_urls = false);
+  // Swaps in |ad_block_client| and applies the known tags and resources to it.
+  void UpdateAdBlockClient(std::unique_ptr<adblock::Engine> ad_block_client);
+  // Has to be called whenever |ad_block_client_| starts matching differently.
+  void OnEngineChanged();
+  // Returns a pointer to bind the tasks posted to the task runner to. It may
+  // only be dereferenced there, and is invalidated once the service is gone.
+  base::WeakPtr<AdBlockBaseService> GetTaskRunnerWeakPtr();
+  // Brings |ad_block_client_| to the filter list |rules| and runs |callback|
+  // on the task runner once it matches with them. When |rules| only adds
+  // network filters to the list the engine was last built from, they are added
+  // to the live engine; anything else rebuilds the engine on the thread pool
+  // and swaps it in once built. |callback| is dropped if a later update
+  // supersedes the rebuild.
+  void UpdateRules(std::string rules,
+                   base::OnceClosure callback = base::DoNothing());
 
   std::unique_ptr<adblock::Engine> ad_block_client_;
 
  private:
-  void UpdateAdBlockClient(std::unique_ptr<adblock::Engine> ad_block_client);
   void OnGetDATFileData(base::OnceClosure callback,
                         GetDATFileDataResult result);
   void OnPreferenceChanges(const std::string& pref_name);
 
+  // Builds a new engine from |rules|, whose filter hashes are |rule_hashes|,
+  // on the thread pool.
+  void RebuildEngine(std::string rules,
+                     std::vector<size_t> rule_hashes,
+                     base::OnceClosure callback);
+  void OnEngineRebuilt(uint64_t generation,
+                       std::vector<size_t> rule_hashes,
+                       base::OnceClosure callback,
+                       std::unique_ptr<adblock::Engine> ad_block_client);
+
+  // The state of the engine rebuilds. It is only used on the task runner and
+  // deleted there, so that the weak pointers bound to the tasks run there,
+  // such as a rebuild's reply, are invalidated on the sequence they are
+  // dereferenced on.
+  struct RebuildState {
+    explicit RebuildState(AdBlockBaseService* service);
+    ~RebuildState();
+
+    // Incremented by each rebuild, so that only the latest one is swapped in.
+    uint64_t generation = 0;
+    bool is_rebuilding = false;
+    base::WeakPtrFactory<AdBlockBaseService> weak_factory;
+  };
+
   std::set<std::string> tags_;
   std::string resources_;
+  // The sorted filter hashes of the list |ad_block_client_| was built from,
+  // empty unless it was built by UpdateRules().
+  std::vector<size_t> rule_hashes_;
+  std::unique_ptr<RebuildState, base::OnTaskRunnerDeleter> rebuild_state_;
+  AdBlockMatchCache match_cache_;
   base::WeakPtrFactory<AdBlockBaseService> weak_factory_;
   DISALLOW_COPY_AND_ASSIGN(AdBlockBaseService);
 };
@@ -0,0 +1,73 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_match_cache.h"
+
+#include "base/metrics/histogram_macros.h"
+#include "base/strings/string_number_conversions.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+AdBlockMatchCache::AdBlockMatchCache(size_t capacity) : cache_(capacity) {}
+
+AdBlockMatchCache::~AdBlockMatchCache() = default;
+
+// static
+std::string AdBlockMatchCache::MakeKey(
+    const GURL& url,
+    const std::string& tab_host,
+    blink::mojom::ResourceType resource_type,
+    bool is_third_party,
+    bool did_match_rule,
+    bool did_match_exception,
+    bool did_match_important) {
+  std::string key;
+  key.reserve(url.spec().size() + tab_host.size() + 8);
+  key.append(base::NumberToString(static_cast<int>(resource_type)));
+  key.push_back(is_third_party ? '1' : '0');
+  key.push_back(did_match_rule ? '1' : '0');
+  key.push_back(did_match_exception ? '1' : '0');
+  key.push_back(did_match_important ? '1' : '0');
+  key.append(tab_host);
+  // Hosts can't contain spaces, so this can't be confused with the url.
+  key.push_back(' ');
+  key.append(url.spec());
+  return key;
+}
+
+bool AdBlockMatchCache::Get(const std::string& key, Result* result) {
+  const bool hit = cache_.Get(key, result);
+  MaybeReportHitRate(false);
+  return hit;
+}
+
+void AdBlockMatchCache::Put(const std::string& key, const Result& result) {
+  cache_.Put(key, result);
+}
+
+void AdBlockMatchCache::Clear() {
+  cache_.Clear();
+  MaybeReportHitRate(true);
+}
+
+ShardedCache<AdBlockMatchCache::Result>::Stats AdBlockMatchCache::GetStats()
+    const {
+  return cache_.GetStats();
+}
+
+void AdBlockMatchCache::MaybeReportHitRate(bool force) {
+  const auto stats = cache_.GetStats();
+  const uint64_t hits = stats.hits - last_reported_stats_.hits;
+  const uint64_t lookups = hits + stats.misses - last_reported_stats_.misses;
+  if (lookups == 0 || (!force && lookups < kReportInterval)) {
+    return;
+  }
+  UMA_HISTOGRAM_PERCENTAGE("Brave.Adblock.MatchCacheHitRate",
+                           static_cast<int>(hits * 100 / lookups));
+  last_reported_stats_ = stats;
+}
+
+}  // namespace brave_shields
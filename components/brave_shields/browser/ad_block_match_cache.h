@@ -0,0 +1,72 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MATCH_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MATCH_CACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "brave/components/brave_shields/browser/sharded_cache.h"
+#include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
+
+class GURL;
+
+namespace brave_shields {
+
+// Remembers what an adblock::Engine returned for a request so that
+// subresources repeated across navigations of the same site (analytics, CDN
+// assets, ...) don't go through the engine again. The engine ORs its result
+// into the flags it is given and skips checks depending on them, so the input
+// flags are part of the key. The cache must be cleared whenever the engine,
+// its tags or its resources change. Like the engine it fronts, it is only
+// used from the owning service's task runner.
+class AdBlockMatchCache {
+ public:
+  static constexpr size_t kDefaultCapacity = 1000;
+
+  // Flags and redirect as left by the engine after matching.
+  struct Result {
+    bool did_match_rule = false;
+    bool did_match_exception = false;
+    bool did_match_important = false;
+    std::string redirect;
+  };
+
+  explicit AdBlockMatchCache(size_t capacity = kDefaultCapacity);
+  AdBlockMatchCache(const AdBlockMatchCache&) = delete;
+  AdBlockMatchCache& operator=(const AdBlockMatchCache&) = delete;
+  ~AdBlockMatchCache();
+
+  // |tab_host| is used rather than its eTLD+1 because $domain= options are
+  // matched against the full host of the tab.
+  static std::string MakeKey(const GURL& url,
+                             const std::string& tab_host,
+                             blink::mojom::ResourceType resource_type,
+                             bool is_third_party,
+                             bool did_match_rule,
+                             bool did_match_exception,
+                             bool did_match_important);
+
+  bool Get(const std::string& key, Result* result);
+  void Put(const std::string& key, const Result& result);
+  // Drops all entries and records the hit rate since the last report.
+  void Clear();
+
+  ShardedCache<Result>::Stats GetStats() const;
+
+ private:
+  static constexpr uint64_t kReportInterval = 10000;
+
+  void MaybeReportHitRate(bool force);
+
+  ShardedCache<Result> cache_;
+  ShardedCache<Result>::Stats last_reported_stats_;
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MATCH_CACHE_H_
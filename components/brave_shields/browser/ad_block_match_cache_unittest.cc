@@ -0,0 +1,78 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <set>
+#include <string>
+
+#include "base/test/metrics/histogram_tester.h"
+#include "brave/components/brave_shields/browser/ad_block_match_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+using blink::mojom::ResourceType;
+
+namespace brave_shields {
+
+TEST(AdBlockMatchCacheTest, KeyCoversEngineInputs) {
+  const GURL url("https://cdn.example.com/analytics.js");
+  std::set<std::string> keys = {
+      AdBlockMatchCache::MakeKey(url, "brave.com", ResourceType::kScript, true,
+                                 false, false, false),
+      AdBlockMatchCache::MakeKey(url, "www.brave.com", ResourceType::kScript,
+                                 true, false, false, false),
+      AdBlockMatchCache::MakeKey(url, "brave.com", ResourceType::kImage, true,
+                                 false, false, false),
+      AdBlockMatchCache::MakeKey(url, "brave.com", ResourceType::kScript,
+                                 false, false, false, false),
+      AdBlockMatchCache::MakeKey(url, "brave.com", ResourceType::kScript, true,
+                                 true, false, false),
+      AdBlockMatchCache::MakeKey(url, "brave.com", ResourceType::kScript, true,
+                                 false, true, false),
+      AdBlockMatchCache::MakeKey(url, "brave.com", ResourceType::kScript, true,
+                                 false, false, true),
+      AdBlockMatchCache::MakeKey(GURL("https://cdn.example.com/other.js"),
+                                 "brave.com", ResourceType::kScript, true,
+                                 false, false, false),
+  };
+  EXPECT_EQ(8u, keys.size());
+}
+
+TEST(AdBlockMatchCacheTest, GetAndClear) {
+  base::HistogramTester histogram_tester;
+  AdBlockMatchCache cache;
+  const std::string key = AdBlockMatchCache::MakeKey(
+      GURL("https://cdn.example.com/analytics.js"), "brave.com",
+      ResourceType::kScript, true, false, false, false);
+
+  AdBlockMatchCache::Result result;
+  EXPECT_FALSE(cache.Get(key, &result));
+
+  AdBlockMatchCache::Result blocked;
+  blocked.did_match_rule = true;
+  blocked.redirect = "data:text/javascript;base64,";
+  cache.Put(key, blocked);
+  ASSERT_TRUE(cache.Get(key, &result));
+  EXPECT_TRUE(result.did_match_rule);
+  EXPECT_FALSE(result.did_match_exception);
+  EXPECT_FALSE(result.did_match_important);
+  EXPECT_EQ(blocked.redirect, result.redirect);
+
+  const auto stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+
+  cache.Clear();
+  EXPECT_FALSE(cache.Get(key, &result));
+  histogram_tester.ExpectUniqueSample("Brave.Adblock.MatchCacheHitRate", 50,
+                                      1);
+
+  // Only the miss above is left to report, after which there is nothing.
+  cache.Clear();
+  cache.Clear();
+  histogram_tester.ExpectBucketCount("Brave.Adblock.MatchCacheHitRate", 0, 1);
+  histogram_tester.ExpectTotalCount("Brave.Adblock.MatchCacheHitRate", 2);
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,81 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_merged_subscription_service.h"
+
+#include <unordered_set>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/strings/string_piece.h"
+#include "base/task/thread_pool.h"
+#include "brave/components/adblock_rust_ffi/src/wrapper.h"
+#include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
+
+namespace brave_shields {
+
+std::string MergeFilterLists(const std::vector<std::string>& lists) {
+  std::string merged;
+  // Points into |lists|, comparing the text so that filters with colliding
+  // hashes are both kept.
+  std::unordered_set<base::StringPiece, base::StringPieceHash> seen_filters;
+  for (const auto& list : lists) {
+    for (const auto& filter : SplitFilterList(list)) {
+      if (!seen_filters.insert(filter).second) {
+        continue;
+      }
+      merged.append(filter.data(), filter.size());
+      merged.push_back('\n');
+    }
+  }
+  return merged;
+}
+
+AdBlockMergedSubscriptionService::AdBlockMergedSubscriptionService(
+    brave_component_updater::BraveComponent::Delegate* delegate)
+    : AdBlockBaseService(delegate) {}
+
+AdBlockMergedSubscriptionService::~AdBlockMergedSubscriptionService() =
+    default;
+
+void AdBlockMergedSubscriptionService::Rebuild(
+    std::vector<base::FilePath> list_files) {
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&AdBlockMergedSubscriptionService::Build,
+                     std::move(list_files)),
+      base::BindOnce(&AdBlockMergedSubscriptionService::OnBuilt,
+                     weak_factory_.GetWeakPtr(), ++build_generation_));
+}
+
+// static
+std::unique_ptr<adblock::Engine> AdBlockMergedSubscriptionService::Build(
+    std::vector<base::FilePath> list_files) {
+  std::vector<std::string> lists;
+  for (const auto& list_file : list_files) {
+    std::string list = brave_component_updater::GetDATFileAsString(list_file);
+    if (!list.empty()) {
+      lists.push_back(std::move(list));
+    }
+  }
+
+  const std::string rules = MergeFilterLists(lists);
+  return std::make_unique<adblock::Engine>(rules.data(), rules.size());
+}
+
+void AdBlockMergedSubscriptionService::OnBuilt(
+    uint64_t generation,
+    std::unique_ptr<adblock::Engine> engine) {
+  if (generation != build_generation_) {
+    return;
+  }
+  GetTaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&AdBlockMergedSubscriptionService::UpdateAdBlockClient,
+                     GetTaskRunnerWeakPtr(), std::move(engine)));
+}
+
+}  // namespace brave_shields
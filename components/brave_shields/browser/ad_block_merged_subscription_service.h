@@ -0,0 +1,56 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MERGED_SUBSCRIPTION_SERVICE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MERGED_SUBSCRIPTION_SERVICE_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/memory/weak_ptr.h"
+#include "brave/components/brave_shields/browser/ad_block_base_service.h"
+
+namespace brave_shields {
+
+// Combines |lists| into a single newline separated list. Filters shared by
+// several lists are only included once.
+std::string MergeFilterLists(const std::vector<std::string>& lists);
+
+// Matches the contents of all enabled filter list subscriptions with a single
+// adblock::Engine, so the cost of a request doesn't grow with the number of
+// subscriptions. The engine is rebuilt on the thread pool whenever the set of
+// lists changes, and swapped in on the task runner, so a request is always
+// matched against one consistent set.
+class AdBlockMergedSubscriptionService : public AdBlockBaseService {
+ public:
+  explicit AdBlockMergedSubscriptionService(
+      brave_component_updater::BraveComponent::Delegate* delegate);
+  AdBlockMergedSubscriptionService(const AdBlockMergedSubscriptionService&) =
+      delete;
+  AdBlockMergedSubscriptionService& operator=(
+      const AdBlockMergedSubscriptionService&) = delete;
+  ~AdBlockMergedSubscriptionService() override;
+
+  // Replaces the merged lists with the contents of |list_files|. A rebuild
+  // requested while a previous one is still running supersedes it.
+  void Rebuild(std::vector<base::FilePath> list_files);
+
+ private:
+  static std::unique_ptr<adblock::Engine> Build(
+      std::vector<base::FilePath> list_files);
+  void OnBuilt(uint64_t generation, std::unique_ptr<adblock::Engine> engine);
+
+  uint64_t build_generation_ = 0;
+
+  base::WeakPtrFactory<AdBlockMergedSubscriptionService> weak_factory_{this};
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MERGED_SUBSCRIPTION_SERVICE_H_
@@ -0,0 +1,135 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "brave/components/adblock_rust_ffi/src/wrapper.h"
+#include "brave/components/brave_shields/browser/ad_block_merged_subscription_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=MergeFilterListsTest.*
+
+namespace brave_shields {
+
+namespace {
+
+struct TestRequest {
+  const char* url;
+  const char* host;
+  const char* tab_host;
+  bool is_third_party;
+  const char* resource_type;
+};
+
+struct MatchFlags {
+  bool did_match_rule = false;
+  bool did_match_exception = false;
+  bool did_match_important = false;
+};
+
+// Matches |request| against every engine in turn, sharing the flags the way
+// AdBlockSubscriptionServiceManager does for per-subscription services.
+MatchFlags Match(const std::vector<std::unique_ptr<adblock::Engine>>& engines,
+                 const TestRequest& request) {
+  MatchFlags flags;
+  for (const auto& engine : engines) {
+    std::string redirect;
+    engine->matches(request.url, request.host, request.tab_host,
+                    request.is_third_party, request.resource_type,
+                    &flags.did_match_rule, &flags.did_match_exception,
+                    &flags.did_match_important, &redirect);
+  }
+  return flags;
+}
+
+}  // namespace
+
+TEST(MergeFilterListsTest, SharedFiltersAreMergedOnce) {
+  const std::vector<std::string> lists = {
+      "[Adblock Plus 2.0]\n"
+      "! Title: first\n"
+      "||ads.example^\n"
+      "##.banner\n",
+      "||ads.example^\n"
+      "\n"
+      "  ||tracker.example^$third-party  \n",
+      "||tracker.example^$third-party\n"
+      "||ads.example^\n",
+  };
+
+  EXPECT_EQ(
+      "||ads.example^\n"
+      "##.banner\n"
+      "||tracker.example^$third-party\n",
+      MergeFilterLists(lists));
+}
+
+TEST(MergeFilterListsTest, DuplicatesWithinOneList) {
+  EXPECT_EQ("||ads.example^\n##.banner\n",
+            MergeFilterLists(
+                {"||ads.example^\n||ads.example^\n", "##.banner\n"}));
+}
+
+TEST(MergeFilterListsTest, FiltersDifferingOnlyInOptionsAreKept) {
+  EXPECT_EQ("||ads.example^\n||ads.example^$script\n",
+            MergeFilterLists({"||ads.example^\n", "||ads.example^$script\n"}));
+}
+
+TEST(MergeFilterListsTest, Empty) {
+  EXPECT_TRUE(MergeFilterLists({}).empty());
+}
+
+TEST(MergeFilterListsTest, MergedEngineMatchesSubscriptionEngines) {
+  const std::vector<std::string> lists = {
+      "||ads.example^\n"
+      "||tracker.example^$third-party\n",
+      "||ads.example^\n"
+      "@@||ads.example/allowed.js\n"
+      "||cdn.example/ad.js$script\n",
+      "||tracker.example^$third-party\n"
+      "||important.example^$important\n"
+      "@@||important.example^\n",
+  };
+  const std::vector<TestRequest> requests = {
+      {"https://ads.example/banner.png", "ads.example", "site.example", true,
+       "image"},
+      {"https://ads.example/allowed.js", "ads.example", "site.example", true,
+       "script"},
+      {"https://tracker.example/pixel", "tracker.example", "site.example",
+       true, "image"},
+      {"https://tracker.example/pixel", "tracker.example", "tracker.example",
+       false, "image"},
+      {"https://cdn.example/ad.js", "cdn.example", "site.example", true,
+       "script"},
+      {"https://cdn.example/ad.js", "cdn.example", "site.example", true,
+       "image"},
+      {"https://important.example/a.js", "important.example", "site.example",
+       true, "script"},
+      {"https://site.example/app.js", "site.example", "site.example", false,
+       "script"},
+  };
+
+  std::vector<std::unique_ptr<adblock::Engine>> subscription_engines;
+  for (const auto& list : lists) {
+    subscription_engines.push_back(std::make_unique<adblock::Engine>(list));
+  }
+  std::vector<std::unique_ptr<adblock::Engine>> merged_engine;
+  merged_engine.push_back(
+      std::make_unique<adblock::Engine>(MergeFilterLists(lists)));
+
+  for (const auto& request : requests) {
+    const MatchFlags expected = Match(subscription_engines, request);
+    const MatchFlags actual = Match(merged_engine, request);
+    EXPECT_EQ(expected.did_match_rule, actual.did_match_rule) << request.url;
+    EXPECT_EQ(expected.did_match_exception, actual.did_match_exception)
+        << request.url;
+    EXPECT_EQ(expected.did_match_important, actual.did_match_important)
+        << request.url;
+  }
+}
+
+}  // namespace brave_shields
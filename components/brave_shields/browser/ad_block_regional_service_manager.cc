@@ -156,6 +156,19 @@ void AdBlockRegionalServiceManager::ShouldStartRequest(
   }
 }
 
+void AdBlockRegionalServiceManager::ShouldStartRequests(
+    const std::string& tab_host,
+    const std::vector<AdBlockMatchRequest*>& requests) {
+  if (!IsInitialized())
+    return;
+
+  base::AutoLock lock(regional_services_lock_);
+
+  for (const auto& regional_service : regional_services_) {
+    regional_service.second->ShouldStartRequests(tab_host, requests);
+  }
+}
+
 absl::optional<std::string> AdBlockRegionalServiceManager::GetCspDirectives(
     const GURL& url,
     blink::mojom::ResourceType resource_type,
@@ -212,6 +225,7 @@ void AdBlockRegionalServiceManager::EnableFilterList(
       it->second->Unregister();
       regional_services_.erase(it);
     }
+    InvalidateAdBlockEngines();
   }
 
   // Update preferences to reflect enabled/disabled state of specified
@@ -260,7 +274,7 @@ AdBlockRegionalServiceManager::HiddenClassIdSelectors(
   absl::optional<base::Value> first_value =
       it->second->HiddenClassIdSelectors(classes, ids, exceptions);
 
-  for ( ; it != regional_services_.end(); it++) {
+  for (it++; it != regional_services_.end(); it++) {
     absl::optional<base::Value> next_value =
         it->second->HiddenClassIdSelectors(classes, ids, exceptions);
     if (first_value && first_value->is_list()) {
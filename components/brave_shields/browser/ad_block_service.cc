@@ -109,6 +109,34 @@ void AdBlockService::ShouldStartRequest(
       did_match_exception, did_match_important, replacement_url);
 }
 
+void AdBlockService::ShouldStartRequests(
+    const std::string& tab_host,
+    const std::vector<AdBlockMatchRequest*>& requests) {
+  if (!IsInitialized())
+    return;
+
+  const std::string tab_domain =
+      net::registry_controlled_domains::GetDomainAndRegistry(
+          tab_host,
+          net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  const bool default_1p_blocking = base::FeatureList::IsEnabled(
+      brave_shields::features::kBraveAdblockDefault1pBlocking);
+  std::vector<AdBlockMatchRequest*> default_engine_requests;
+  for (AdBlockMatchRequest* request : requests) {
+    if (request->aggressive_blocking || default_1p_blocking ||
+        IsThirdPartyRequest(request->url, tab_host, tab_domain)) {
+      default_engine_requests.push_back(request);
+    }
+  }
+  AdBlockBaseService::ShouldStartRequests(tab_host, default_engine_requests);
+
+  // Requests that already matched an important rule are skipped by every
+  // list, like the early returns in ShouldStartRequest().
+  regional_service_manager()->ShouldStartRequests(tab_host, requests);
+  subscription_service_manager()->ShouldStartRequests(tab_host, requests);
+  custom_filters_service()->ShouldStartRequests(tab_host, requests);
+}
+
 absl::optional<std::string> AdBlockService::GetCspDirectives(
     const GURL& url,
     blink::mojom::ResourceType resource_type,
@@ -60,6 +60,9 @@ class AdBlockService : public AdBlockBaseService {
                           bool* did_match_exception,
                           bool* did_match_important,
                           std::string* replacement_url) override;
+  void ShouldStartRequests(
+      const std::string& tab_host,
+      const std::vector<AdBlockMatchRequest*>& requests) override;
   absl::optional<std::string> GetCspDirectives(
       const GURL& url,
       blink::mojom::ResourceType resource_type,
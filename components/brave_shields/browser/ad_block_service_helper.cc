@@ -6,18 +6,29 @@
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 
 #include <algorithm>
+#include <atomic>
 #include <utility>
 
+#include "base/containers/cxx20_erase.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/path_service.h"
+#include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/values.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "url/gurl.h"
 
 using adblock::FilterList;
 
 namespace brave_shields {
 
+namespace {
+
+std::atomic<uint64_t> g_engines_version{0};
+
+}  // namespace
+
 std::vector<FilterList>::const_iterator FindAdBlockFilterListByUUID(
     const std::vector<FilterList>& region_lists,
     const std::string& uuid) {
@@ -215,4 +226,66 @@ void MergeResourcesInto(base::Value from, base::Value* into, bool force_hide) {
   }
 }
 
+adblock::RequestType ResourceTypeToRequestType(
+    blink::mojom::ResourceType resource_type) {
+  switch (resource_type) {
+    case blink::mojom::ResourceType::kMainFrame:
+      return C_RequestType_MainFrame;
+    case blink::mojom::ResourceType::kSubFrame:
+      return C_RequestType_SubFrame;
+    case blink::mojom::ResourceType::kStylesheet:
+      return C_RequestType_Stylesheet;
+    case blink::mojom::ResourceType::kScript:
+      return C_RequestType_Script;
+    case blink::mojom::ResourceType::kFavicon:
+    case blink::mojom::ResourceType::kImage:
+      return C_RequestType_Image;
+    case blink::mojom::ResourceType::kFontResource:
+      return C_RequestType_Font;
+    case blink::mojom::ResourceType::kSubResource:
+      return C_RequestType_Other;
+    case blink::mojom::ResourceType::kObject:
+      return C_RequestType_Object;
+    case blink::mojom::ResourceType::kMedia:
+      return C_RequestType_Media;
+    case blink::mojom::ResourceType::kXhr:
+      return C_RequestType_Xhr;
+    case blink::mojom::ResourceType::kPing:
+      return C_RequestType_Ping;
+    default:
+      return C_RequestType_Unknown;
+  }
+}
+
+bool IsThirdPartyRequest(const GURL& url,
+                         const std::string& tab_host,
+                         const std::string& tab_domain) {
+  if (!tab_host.empty() && url.host_piece() == tab_host) {
+    return false;
+  }
+  if (tab_domain.empty()) {
+    return true;
+  }
+  return net::registry_controlled_domains::GetDomainAndRegistry(
+             url, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES) !=
+         tab_domain;
+}
+
+std::vector<base::StringPiece> SplitFilterList(base::StringPiece rules) {
+  std::vector<base::StringPiece> filters = base::SplitStringPiece(
+      rules, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  base::EraseIf(filters, [](base::StringPiece line) {
+    return base::StartsWith(line, "!") || base::StartsWith(line, "[");
+  });
+  return filters;
+}
+
+uint64_t GetAdBlockEnginesVersion() {
+  return g_engines_version.load(std::memory_order_acquire);
+}
+
+void InvalidateAdBlockEngines() {
+  g_engines_version.fetch_add(1, std::memory_order_acq_rel);
+}
+
 }  // namespace brave_shields
@@ -11,8 +11,12 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "base/strings/string_piece.h"
 #include "base/values.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
+#include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
+
+class GURL;
 
 namespace brave_shields {
 
@@ -31,6 +35,26 @@ void MergeCspDirectiveInto(absl::optional<std::string> from,
 
 void MergeResourcesInto(base::Value from, base::Value* into, bool force_hide);
 
+adblock::RequestType ResourceTypeToRequestType(
+    blink::mojom::ResourceType resource_type);
+
+// Same as !SameDomainOrHost(url, tab origin), for callers that check many
+// urls against one tab and computed |tab_domain|, the eTLD+1 of |tab_host|,
+// up front.
+bool IsThirdPartyRequest(const GURL& url,
+                         const std::string& tab_host,
+                         const std::string& tab_domain);
+
+// Splits the text of a filter list into its filters, leaving out blank lines,
+// comments and the "[Adblock Plus x.y]" header.
+std::vector<base::StringPiece> SplitFilterList(base::StringPiece rules);
+
+// Returns a version that changes whenever any ad-block engine changes or a
+// filter list is enabled or disabled, so results combined from several
+// engines can be cached until then. Both can be called on any thread.
+uint64_t GetAdBlockEnginesVersion();
+void InvalidateAdBlockEngines();
+
 }  // namespace brave_shields
 
 #endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_SERVICE_HELPER_H_
@@ -5,11 +5,18 @@
 
 #include "brave/components/brave_shields/browser/ad_block_subscription_service.h"
 
+#include <utility>
+
+#include "base/bind.h"
 #include "base/files/file_path.h"
 #include "base/json/json_value_converter.h"
 #include "base/json/values_util.h"
 #include "base/logging.h"
 #include "base/strings/string_piece.h"
+#include "base/task/bind_post_task.h"
+#include "base/task/thread_pool.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "brave/components/brave_component_updater/browser/dat_file_util.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
@@ -58,6 +65,15 @@ AdBlockSubscriptionService::AdBlockSubscriptionService(
 
 AdBlockSubscriptionService::~AdBlockSubscriptionService() {}
 
+// static
+void AdBlockSubscriptionService::DeleteSoon(
+    std::unique_ptr<AdBlockSubscriptionService> service) {
+  service->weak_factory_.InvalidateWeakPtrs();
+  scoped_refptr<base::SequencedTaskRunner> task_runner =
+      service->GetTaskRunner();
+  task_runner->DeleteSoon(FROM_HERE, std::move(service));
+}
+
 bool AdBlockSubscriptionService::Init() {
   if (!AdBlockBaseService::Init())
     return false;
@@ -75,9 +91,32 @@ bool AdBlockSubscriptionService::Init() {
 }
 
 void AdBlockSubscriptionService::ReloadList() {
-  GetDATFileData(list_file_, false,
-                 base::BindOnce(&AdBlockSubscriptionService::OnListLoaded,
-                                weak_factory_.GetWeakPtr()));
+  // The list is read as text rather than handed straight to a new engine so
+  // that an update which only adds filters can be applied to the live engine.
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::MayBlock()},
+      base::BindOnce(&brave_component_updater::GetDATFileAsString, list_file_),
+      base::BindOnce(&AdBlockSubscriptionService::OnListFileRead,
+                     weak_factory_.GetWeakPtr()));
+}
+
+void AdBlockSubscriptionService::OnListFileRead(std::string rules) {
+  if (rules.empty()) {
+    LOG(ERROR) << "Could not obtain ad block subscription data";
+    return;
+  }
+  // base::Unretained is ok here because the service is only ever deleted on
+  // the task runner, after this task has run. The service is marked as loaded
+  // once the engine matches with |rules|, which may be after a rebuild.
+  GetTaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          &AdBlockSubscriptionService::UpdateRules, base::Unretained(this),
+          std::move(rules),
+          base::BindPostTask(
+              base::SequencedTaskRunnerHandle::Get(),
+              base::BindOnce(&AdBlockSubscriptionService::OnListLoaded,
+                             weak_factory_.GetWeakPtr()))));
 }
 
 void AdBlockSubscriptionService::OnListLoaded() {
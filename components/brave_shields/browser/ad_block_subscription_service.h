@@ -55,6 +55,11 @@ class AdBlockSubscriptionService : public AdBlockBaseService {
       brave_component_updater::BraveComponent::Delegate* delegate);
   ~AdBlockSubscriptionService() override;
 
+  // Drops the replies pending on the UI thread and deletes |service| on the
+  // task runner, once the tasks already posted there have run. Must be called
+  // on the UI thread.
+  static void DeleteSoon(std::unique_ptr<AdBlockSubscriptionService> service);
+
   void ReloadList();
 
   bool Init() override;
@@ -62,6 +67,7 @@ class AdBlockSubscriptionService : public AdBlockBaseService {
  private:
   friend class ::AdBlockServiceTest;
 
+  void OnListFileRead(std::string rules);
   void OnListLoaded();
 
   GURL subscription_url_;
@@ -11,6 +11,7 @@
 
 #include "base/base64url.h"
 #include "base/bind.h"
+#include "base/feature_list.h"
 #include "base/files/file_util.h"
 #include "base/json/json_value_converter.h"
 #include "base/json/values_util.h"
@@ -24,6 +25,7 @@
 #include "brave/components/brave_shields/browser/ad_block_subscription_service.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_service_manager_observer.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "brave/components/brave_shields/common/features.h"
 #include "brave/components/brave_shields/common/pref_names.h"
 #include "components/prefs/pref_service.h"
 #include "components/prefs/scoped_user_pref_update.h"
@@ -70,6 +72,9 @@ AdBlockSubscriptionServiceManager::AdBlockSubscriptionServiceManager(
       subscriptions_(new base::DictionaryValue()),
       subscription_update_timer_(
           std::make_unique<component_updater::TimerUpdateScheduler>()) {
+  if (base::FeatureList::IsEnabled(features::kBraveAdblockMergedSubscriptions))
+    merged_service_ =
+        std::make_unique<AdBlockMergedSubscriptionService>(delegate_);
   std::move(download_manager_getter)
       .Run(base::BindOnce(
           &AdBlockSubscriptionServiceManager::OnGetDownloadManager,
@@ -164,9 +169,7 @@ void AdBlockSubscriptionServiceManager::CreateSubscription(
   info.last_successful_update_attempt = base::Time();
   info.enabled = true;
 
-  auto subscription_service = std::make_unique<AdBlockSubscriptionService>(
-      info, GetSubscriptionPath(sub_url).Append(kCustomSubscriptionListText),
-      delegate_);
+  auto subscription_service = CreateSubscriptionService(info);
   UpdateSubscriptionPrefs(sub_url, info);
 
   {
@@ -202,18 +205,25 @@ void AdBlockSubscriptionServiceManager::EnableSubscription(const GURL& sub_url,
   info->enabled = enabled;
 
   UpdateSubscriptionPrefs(sub_url, *info);
+  RebuildMergedService();
 }
 
 void AdBlockSubscriptionServiceManager::DeleteSubscription(
     const GURL& sub_url) {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  std::unique_ptr<AdBlockSubscriptionService> subscription_service;
   {
     base::AutoLock lock(subscription_services_lock_);
     auto it = subscription_services_.find(sub_url);
     DCHECK(it != subscription_services_.end());
+    subscription_service = std::move(it->second);
     subscription_services_.erase(it);
   }
+  // The service may still be updating its engine on the task runner.
+  if (subscription_service)
+    AdBlockSubscriptionService::DeleteSoon(std::move(subscription_service));
   ClearSubscriptionPrefs(sub_url);
+  RebuildMergedService();
 
   base::ThreadPool::PostTask(
       FROM_HERE,
@@ -247,6 +257,7 @@ void AdBlockSubscriptionServiceManager::OnGetDownloadManager(
 
   download_manager_->CancelAllPendingDownloads();
   LoadSubscriptionServices();
+  RebuildMergedService();
 
   subscription_update_timer_->Schedule(
       kListCheckInitialDelay, kListRetryInterval,
@@ -266,6 +277,20 @@ void AdBlockSubscriptionServiceManager::SetUpdateIntervalsForTesting(
       base::DoNothing());
 }
 
+std::unique_ptr<AdBlockSubscriptionService>
+AdBlockSubscriptionServiceManager::CreateSubscriptionService(
+    const SubscriptionInfo& info) {
+  // The merged engine reads the list files itself, so no per-subscription
+  // engine is built.
+  if (merged_service_)
+    return nullptr;
+  return std::make_unique<AdBlockSubscriptionService>(
+      info,
+      GetSubscriptionPath(info.subscription_url)
+          .Append(kCustomSubscriptionListText),
+      delegate_);
+}
+
 absl::optional<SubscriptionInfo> AdBlockSubscriptionServiceManager::GetInfo(
     const GURL& sub_url) {
   auto* list_subscription_dict = subscriptions_->FindKey(sub_url.spec());
@@ -297,10 +322,7 @@ void AdBlockSubscriptionServiceManager::LoadSubscriptionServices() {
       GURL sub_url(key);
       info = BuildInfoFromDict(sub_url, list_subscription_dict);
 
-      auto subscription_service = std::make_unique<AdBlockSubscriptionService>(
-          info,
-          GetSubscriptionPath(sub_url).Append(kCustomSubscriptionListText),
-          delegate_);
+      auto subscription_service = CreateSubscriptionService(info);
 
       subscription_services_.insert(
           std::make_pair(sub_url, std::move(subscription_service)));
@@ -333,6 +355,8 @@ void AdBlockSubscriptionServiceManager::UpdateSubscriptionPrefs(
   base::AutoLock lock(subscription_services_lock_);
   subscriptions_ = base::DictionaryValue::From(
       base::Value::ToUniquePtrValue(subscriptions_dict->Clone()));
+  // The enabled state of the subscription may have changed.
+  InvalidateAdBlockEngines();
 }
 
 // Updates preferences to remove all state for the specified filter list
@@ -352,16 +376,38 @@ void AdBlockSubscriptionServiceManager::ClearSubscriptionPrefs(
   base::AutoLock lock(subscription_services_lock_);
   subscriptions_ = base::DictionaryValue::From(
       base::Value::ToUniquePtrValue(subscriptions_dict->Clone()));
+  InvalidateAdBlockEngines();
 }
 
 bool AdBlockSubscriptionServiceManager::Start() {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (merged_service_) {
+    merged_service_->Start();
+    RebuildMergedService();
+    return true;
+  }
   for (const auto& subscription_service : subscription_services_) {
     subscription_service.second->Start();
   }
   return true;
 }
 
+void AdBlockSubscriptionServiceManager::RebuildMergedService() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (!merged_service_)
+    return;
+
+  std::vector<base::FilePath> list_files;
+  for (const auto& subscription_service : subscription_services_) {
+    auto info = GetInfo(subscription_service.first);
+    if (info && info->enabled) {
+      list_files.push_back(GetSubscriptionPath(subscription_service.first)
+                               .Append(kCustomSubscriptionListText));
+    }
+  }
+  merged_service_->Rebuild(std::move(list_files));
+}
+
 void AdBlockSubscriptionServiceManager::ShouldStartRequest(
     const GURL& url,
     blink::mojom::ResourceType resource_type,
@@ -371,6 +417,13 @@ void AdBlockSubscriptionServiceManager::ShouldStartRequest(
     bool* did_match_exception,
     bool* did_match_important,
     std::string* adblock_replacement_url) {
+  if (merged_service_) {
+    merged_service_->ShouldStartRequest(
+        url, resource_type, tab_host, aggressive_blocking, did_match_rule,
+        did_match_exception, did_match_important, adblock_replacement_url);
+    return;
+  }
+
   base::AutoLock lock(subscription_services_lock_);
   for (const auto& subscription_service : subscription_services_) {
     auto info = GetInfo(subscription_service.first);
@@ -385,9 +438,30 @@ void AdBlockSubscriptionServiceManager::ShouldStartRequest(
   }
 }
 
+void AdBlockSubscriptionServiceManager::ShouldStartRequests(
+    const std::string& tab_host,
+    const std::vector<AdBlockMatchRequest*>& requests) {
+  if (merged_service_) {
+    merged_service_->ShouldStartRequests(tab_host, requests);
+    return;
+  }
+
+  base::AutoLock lock(subscription_services_lock_);
+  for (const auto& subscription_service : subscription_services_) {
+    auto info = GetInfo(subscription_service.first);
+    if (info && info->enabled) {
+      subscription_service.second->ShouldStartRequests(tab_host, requests);
+    }
+  }
+}
+
 void AdBlockSubscriptionServiceManager::EnableTag(const std::string& tag,
                                                   bool enabled) {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (merged_service_) {
+    merged_service_->EnableTag(tag, enabled);
+    return;
+  }
   for (const auto& subscription_service : subscription_services_) {
     subscription_service.second->EnableTag(tag, enabled);
   }
@@ -396,6 +470,10 @@ void AdBlockSubscriptionServiceManager::EnableTag(const std::string& tag,
 void AdBlockSubscriptionServiceManager::AddResources(
     const std::string& resources) {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (merged_service_) {
+    merged_service_->AddResources(resources);
+    return;
+  }
   for (const auto& subscription_service : subscription_services_) {
     subscription_service.second->AddResources(resources);
   }
@@ -404,6 +482,9 @@ void AdBlockSubscriptionServiceManager::AddResources(
 absl::optional<base::Value>
 AdBlockSubscriptionServiceManager::UrlCosmeticResources(
     const std::string& url) {
+  if (merged_service_)
+    return merged_service_->UrlCosmeticResources(url);
+
   absl::optional<base::Value> first_value = absl::nullopt;
 
   base::AutoLock lock(subscription_services_lock_);
@@ -431,6 +512,9 @@ AdBlockSubscriptionServiceManager::HiddenClassIdSelectors(
     const std::vector<std::string>& classes,
     const std::vector<std::string>& ids,
     const std::vector<std::string>& exceptions) {
+  if (merged_service_)
+    return merged_service_->HiddenClassIdSelectors(classes, ids, exceptions);
+
   absl::optional<base::Value> first_value = absl::nullopt;
 
   base::AutoLock lock(subscription_services_lock_);
@@ -471,7 +555,10 @@ void AdBlockSubscriptionServiceManager::OnSubscriptionDownloaded(
   info->last_successful_update_attempt = info->last_update_attempt;
   UpdateSubscriptionPrefs(sub_url, *info);
 
-  it->second->ReloadList();
+  if (merged_service_)
+    RebuildMergedService();
+  else
+    it->second->ReloadList();
 
   NotifyObserversOfServiceEvent();
 }
@@ -19,6 +19,7 @@
 #include "base/threading/thread_checker.h"
 #include "base/values.h"
 #include "brave/components/brave_component_updater/browser/brave_component.h"
+#include "brave/components/brave_shields/browser/ad_block_merged_subscription_service.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_download_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_service.h"
 #include "components/component_updater/timer_update_scheduler.h"
@@ -66,6 +67,8 @@ class AdBlockSubscriptionServiceManager {
                           bool* did_match_exception,
                           bool* did_match_important,
                           std::string* adblock_replacement_url);
+  void ShouldStartRequests(const std::string& tab_host,
+                           const std::vector<AdBlockMatchRequest*>& requests);
   void EnableTag(const std::string& tag, bool enabled);
   void AddResources(const std::string& resources);
 
@@ -98,6 +101,10 @@ class AdBlockSubscriptionServiceManager {
 
   bool Init();
   void LoadSubscriptionServices();
+  // Returns the service matching the list of |info|, or nullptr when all
+  // subscriptions are matched by |merged_service_|.
+  std::unique_ptr<AdBlockSubscriptionService> CreateSubscriptionService(
+      const SubscriptionInfo& info);
   void UpdateSubscriptionPrefs(const GURL& sub_url,
                                const SubscriptionInfo& info);
   void ClearSubscriptionPrefs(const GURL& sub_url);
@@ -106,6 +113,8 @@ class AdBlockSubscriptionServiceManager {
 
   absl::optional<SubscriptionInfo> GetInfo(const GURL& sub_url);
   void NotifyObserversOfServiceEvent();
+  // Rebuilds the merged engine from the currently enabled subscriptions.
+  void RebuildMergedService();
 
   void SetUpdateIntervalsForTesting(base::TimeDelta* initial_delay,
                                     base::TimeDelta* retry_interval);
@@ -117,6 +126,10 @@ class AdBlockSubscriptionServiceManager {
 
   std::map<GURL, std::unique_ptr<AdBlockSubscriptionService>>
       subscription_services_;
+  // Set when all subscriptions are matched by a single engine, in which case
+  // |subscription_services_| only keeps track of the subscription URLs and
+  // maps them to nullptr.
+  std::unique_ptr<AdBlockMergedSubscriptionService> merged_service_;
   std::unique_ptr<component_updater::TimerUpdateScheduler>
       subscription_update_timer_;
 
@@ -10,21 +10,22 @@
 
 TEST(HTTPSEverywhereRecentlyUsedCacheTest, Operations) {
   using Cache = HTTPSERecentlyUsedCache<std::string>;
-  Cache cache(3);
+  // A single shard keeps eviction order deterministic.
+  Cache cache(3, 1);
 
   // Test add/get and check that max size is maintained.
-  cache.add("kA", "vA");
-  cache.add("kB", "vB");
-  cache.add("kC", "vC");
+  cache.Put("kA", "vA");
+  cache.Put("kB", "vB");
+  cache.Put("kC", "vC");
   std::string v;
-  ASSERT_TRUE(cache.get("kA", &v));
+  ASSERT_TRUE(cache.Get("kA", &v));
   ASSERT_STREQ(v.c_str(), "vA");
-  // kA just became MRU, so adding a new k/v pair should evict the oldest.
-  cache.add("kD", "vD");
-  ASSERT_FALSE(cache.get("kB", &v));
-  ASSERT_TRUE(cache.get("kD", &v));
+  // kA was just referenced, so adding a new k/v pair should evict kB.
+  cache.Put("kD", "vD");
+  ASSERT_FALSE(cache.Get("kB", &v));
+  ASSERT_TRUE(cache.Get("kD", &v));
 
   // Test remove.
-  cache.remove("kD");
-  ASSERT_FALSE(cache.get("kD", &v));
+  cache.Erase("kD");
+  ASSERT_FALSE(cache.Get("kD", &v));
 }
@@ -0,0 +1,89 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_redirect_tracker.h"
+
+#include "base/time/tick_clock.h"
+
+namespace brave_shields {
+
+HTTPSERedirectTracker::Shard::Shard() = default;
+HTTPSERedirectTracker::Shard::~Shard() = default;
+
+HTTPSERedirectTracker::HTTPSERedirectTracker(unsigned int max_redirects,
+                                             base::TimeDelta ttl,
+                                             const base::TickClock* clock)
+    : max_redirects_(max_redirects), ttl_(ttl), clock_(clock) {}
+
+HTTPSERedirectTracker::~HTTPSERedirectTracker() = default;
+
+bool HTTPSERedirectTracker::ShouldRedirect(uint64_t request_identifier) {
+  Shard& shard = GetShard(request_identifier);
+  base::AutoLock lock(shard.lock);
+  auto it = shard.entries.find(request_identifier);
+  if (it == shard.entries.end()) {
+    return true;
+  }
+  if (clock_->NowTicks() - it->second.last_updated > ttl_) {
+    shard.entries.erase(it);
+    return true;
+  }
+  return it->second.redirects < max_redirects_ - 1;
+}
+
+void HTTPSERedirectTracker::AddRedirect(uint64_t request_identifier) {
+  const base::TimeTicks now = clock_->NowTicks();
+  Shard& shard = GetShard(request_identifier);
+  base::AutoLock lock(shard.lock);
+  auto it = shard.entries.find(request_identifier);
+  if (it != shard.entries.end() && now - it->second.last_updated <= ttl_) {
+    it->second.redirects++;
+    it->second.last_updated = now;
+    return;
+  }
+
+  if (it == shard.entries.end() &&
+      shard.entries.size() >= kMaxEntriesPerShard) {
+    MakeRoom(&shard, now);
+  }
+  Entry& entry = shard.entries[request_identifier];
+  entry.redirects = 1;
+  entry.last_updated = now;
+}
+
+size_t HTTPSERedirectTracker::GetSizeForTesting() {
+  size_t size = 0;
+  for (auto& shard : shards_) {
+    base::AutoLock lock(shard.lock);
+    size += shard.entries.size();
+  }
+  return size;
+}
+
+HTTPSERedirectTracker::Shard& HTTPSERedirectTracker::GetShard(
+    uint64_t request_identifier) {
+  return shards_[request_identifier % kShardCount];
+}
+
+void HTTPSERedirectTracker::MakeRoom(Shard* shard, base::TimeTicks now) {
+  auto oldest = shard->entries.end();
+  for (auto it = shard->entries.begin(); it != shard->entries.end();) {
+    if (now - it->second.last_updated > ttl_) {
+      it = shard->entries.erase(it);
+      continue;
+    }
+    if (oldest == shard->entries.end() ||
+        it->second.last_updated < oldest->second.last_updated) {
+      oldest = it;
+    }
+    ++it;
+  }
+
+  if (shard->entries.size() >= kMaxEntriesPerShard) {
+    shard->entries.erase(oldest);
+  }
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,74 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_REDIRECT_TRACKER_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_REDIRECT_TRACKER_H_
+
+#include <stdint.h>
+
+#include <array>
+#include <unordered_map>
+
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace base {
+class TickClock;
+}  // namespace base
+
+namespace brave_shields {
+
+// Counts HTTPSE redirects per in-flight request so a request bouncing between
+// http and https is only upgraded a bounded number of times. Requests are
+// spread over independently locked shards, and entries that haven't been
+// touched for |ttl| are dropped, so hundreds of parallel page loads keep their
+// own state without evicting each other.
+class HTTPSERedirectTracker {
+ public:
+  HTTPSERedirectTracker(unsigned int max_redirects,
+                        base::TimeDelta ttl,
+                        const base::TickClock* clock);
+  HTTPSERedirectTracker(const HTTPSERedirectTracker&) = delete;
+  HTTPSERedirectTracker& operator=(const HTTPSERedirectTracker&) = delete;
+  ~HTTPSERedirectTracker();
+
+  // Returns false once |request_identifier| used up its redirects.
+  bool ShouldRedirect(uint64_t request_identifier);
+  // Records one more redirect for |request_identifier|.
+  void AddRedirect(uint64_t request_identifier);
+
+  size_t GetSizeForTesting();
+
+ private:
+  static constexpr size_t kShardCount = 16;
+  static constexpr size_t kMaxEntriesPerShard = 64;
+
+  struct Entry {
+    unsigned int redirects = 0;
+    base::TimeTicks last_updated;
+  };
+
+  struct Shard {
+    Shard();
+    ~Shard();
+
+    base::Lock lock;
+    std::unordered_map<uint64_t, Entry> entries;
+  };
+
+  Shard& GetShard(uint64_t request_identifier);
+  // Drops expired entries and, if the shard is still full, the least
+  // recently updated one. Must be called with |shard.lock| held.
+  void MakeRoom(Shard* shard, base::TimeTicks now);
+
+  const unsigned int max_redirects_;
+  const base::TimeDelta ttl_;
+  const base::TickClock* clock_;
+  std::array<Shard, kShardCount> shards_;
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_REDIRECT_TRACKER_H_
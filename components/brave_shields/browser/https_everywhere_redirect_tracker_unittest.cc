@@ -0,0 +1,77 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_redirect_tracker.h"
+
+#include "base/test/simple_test_tick_clock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr unsigned int kMaxRedirects = 5;
+constexpr base::TimeDelta kTTL = base::TimeDelta::FromSeconds(60);
+
+}  // namespace
+
+TEST(HTTPSERedirectTrackerTest, StopsAfterMaxRedirects) {
+  base::SimpleTestTickClock clock;
+  HTTPSERedirectTracker tracker(kMaxRedirects, kTTL, &clock);
+
+  for (unsigned int i = 0; i < kMaxRedirects - 1; ++i) {
+    EXPECT_TRUE(tracker.ShouldRedirect(1));
+    tracker.AddRedirect(1);
+  }
+  EXPECT_FALSE(tracker.ShouldRedirect(1));
+}
+
+TEST(HTTPSERedirectTrackerTest, ParallelRequestsKeepTheirState) {
+  base::SimpleTestTickClock clock;
+  HTTPSERedirectTracker tracker(kMaxRedirects, kTTL, &clock);
+
+  for (unsigned int i = 0; i < kMaxRedirects - 1; ++i) {
+    for (uint64_t request = 0; request < 500; ++request) {
+      tracker.AddRedirect(request);
+    }
+  }
+  // Loop protection used to be lost as soon as another request redirected.
+  for (uint64_t request = 0; request < 500; ++request) {
+    EXPECT_FALSE(tracker.ShouldRedirect(request));
+  }
+  EXPECT_TRUE(tracker.ShouldRedirect(500));
+}
+
+TEST(HTTPSERedirectTrackerTest, EntriesExpire) {
+  base::SimpleTestTickClock clock;
+  HTTPSERedirectTracker tracker(kMaxRedirects, kTTL, &clock);
+
+  for (unsigned int i = 0; i < kMaxRedirects - 1; ++i) {
+    tracker.AddRedirect(1);
+  }
+  EXPECT_FALSE(tracker.ShouldRedirect(1));
+
+  clock.Advance(kTTL + base::TimeDelta::FromSeconds(1));
+  EXPECT_TRUE(tracker.ShouldRedirect(1));
+  EXPECT_EQ(0u, tracker.GetSizeForTesting());
+}
+
+TEST(HTTPSERedirectTrackerTest, SizeIsBounded) {
+  base::SimpleTestTickClock clock;
+  HTTPSERedirectTracker tracker(kMaxRedirects, kTTL, &clock);
+
+  for (uint64_t request = 0; request < 100000; ++request) {
+    tracker.AddRedirect(request);
+    clock.Advance(base::TimeDelta::FromMilliseconds(1));
+  }
+  EXPECT_LE(tracker.GetSizeForTesting(), 1024u);
+  // The most recent request is still tracked.
+  for (unsigned int i = 0; i < kMaxRedirects - 2; ++i) {
+    tracker.AddRedirect(99999);
+  }
+  EXPECT_FALSE(tracker.ShouldRedirect(99999));
+}
+
+}  // namespace brave_shields
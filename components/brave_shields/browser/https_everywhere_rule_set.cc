@@ -0,0 +1,137 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_set.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/json/json_reader.h"
+#include "base/memory/ptr_util.h"
+#include "base/values.h"
+#include "third_party/re2/src/re2/re2.h"
+
+namespace brave_shields {
+
+HTTPSERuleSet::Rule::Rule() = default;
+HTTPSERuleSet::Rule::Rule(Rule&&) = default;
+HTTPSERuleSet::Rule& HTTPSERuleSet::Rule::operator=(Rule&&) = default;
+HTTPSERuleSet::Rule::~Rule() = default;
+
+HTTPSERuleSet::Target::Target() = default;
+HTTPSERuleSet::Target::Target(Target&&) = default;
+HTTPSERuleSet::Target& HTTPSERuleSet::Target::operator=(Target&&) = default;
+HTTPSERuleSet::Target::~Target() = default;
+
+HTTPSERuleSet::HTTPSERuleSet() = default;
+HTTPSERuleSet::~HTTPSERuleSet() = default;
+
+// static
+std::unique_ptr<HTTPSERuleSet> HTTPSERuleSet::Parse(const std::string& json) {
+  absl::optional<base::Value> json_object = base::JSONReader::Read(json);
+  if (!json_object || !json_object->is_list()) {
+    return nullptr;
+  }
+
+  auto rule_set = base::WrapUnique(new HTTPSERuleSet());
+  for (const auto& target_value : json_object->GetList()) {
+    if (!target_value.is_dict()) {
+      continue;
+    }
+
+    Target target;
+    const base::Value* exclusions = target_value.FindListKey("e");
+    if (exclusions) {
+      for (const auto& exclusion : exclusions->GetList()) {
+        if (!exclusion.is_dict()) {
+          continue;
+        }
+        const std::string* pattern = exclusion.FindStringKey("p");
+        if (!pattern) {
+          continue;
+        }
+        auto regexp = std::make_unique<re2::RE2>(CorrectToRuleForRE2(*pattern));
+        // An invalid pattern never matches, so there is no point keeping it.
+        if (regexp->ok()) {
+          target.exclusions.push_back(std::move(regexp));
+        }
+      }
+    }
+
+    const base::Value* rules = target_value.FindListKey("r");
+    target.has_rules = rules != nullptr;
+    if (rules) {
+      for (const auto& rule_value : rules->GetList()) {
+        if (!rule_value.is_dict()) {
+          continue;
+        }
+        Rule rule;
+        if (rule_value.FindKey("d")) {
+          rule.upgrade_scheme = true;
+          target.rules.push_back(std::move(rule));
+          // Nothing after a scheme upgrade can ever be reached.
+          break;
+        }
+        const std::string* from = rule_value.FindStringKey("f");
+        const std::string* to = rule_value.FindStringKey("t");
+        if (!from || !to) {
+          continue;
+        }
+        rule.from = std::make_unique<re2::RE2>(*from);
+        if (!rule.from->ok()) {
+          continue;
+        }
+        rule.to = CorrectToRuleForRE2(*to);
+        target.rules.push_back(std::move(rule));
+      }
+    }
+
+    const bool has_rules = target.has_rules;
+    rule_set->targets_.push_back(std::move(target));
+    // Evaluation stops at the first target without rules, later ones are
+    // unreachable.
+    if (!has_rules) {
+      break;
+    }
+  }
+
+  return rule_set;
+}
+
+std::string HTTPSERuleSet::Apply(const std::string& url) const {
+  for (const auto& target : targets_) {
+    for (const auto& exclusion : target.exclusions) {
+      if (re2::RE2::FullMatch(url, *exclusion)) {
+        return "";
+      }
+    }
+
+    if (!target.has_rules) {
+      return "";
+    }
+
+    for (const auto& rule : target.rules) {
+      if (rule.upgrade_scheme) {
+        std::string new_url(url);
+        return new_url.insert(4, "s");
+      }
+
+      std::string new_url(url);
+      if (re2::RE2::Replace(&new_url, *rule.from, rule.to) && new_url != url) {
+        return new_url;
+      }
+    }
+  }
+  return "";
+}
+
+// static
+std::string HTTPSERuleSet::CorrectToRuleForRE2(const std::string& to) {
+  std::string corrected_to(to);
+  std::replace(corrected_to.begin(), corrected_to.end(), '$', '\\');
+  return corrected_to;
+}
+
+}  // namespace brave_shields
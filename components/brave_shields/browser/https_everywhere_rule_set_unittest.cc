@@ -0,0 +1,131 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/components/brave_shields/browser/https_everywhere_rule_set.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+namespace {
+
+const char kRules[] = R"([{
+    "e": [{"p": "^http://www\\.example\\.com/no-https/"}],
+    "r": [
+      {"f": "^http://(www\\.)?example\\.com/", "t": "https://$1example.com/"}
+    ]
+  }])";
+
+const char kUpgradeRules[] = R"([{"r": [{"d": 1}]}])";
+
+const char kTargetWithoutRules[] = R"([
+    {"e": []},
+    {"r": [{"d": 1}]}
+  ])";
+
+}  // namespace
+
+TEST(HTTPSERuleSetTest, InvalidJson) {
+  EXPECT_FALSE(HTTPSERuleSet::Parse(""));
+  EXPECT_FALSE(HTTPSERuleSet::Parse("{}"));
+  EXPECT_FALSE(HTTPSERuleSet::Parse("[{"));
+}
+
+TEST(HTTPSERuleSetTest, Rewrite) {
+  auto rule_set = HTTPSERuleSet::Parse(kRules);
+  ASSERT_TRUE(rule_set);
+  EXPECT_EQ("https://www.example.com/",
+            rule_set->Apply("http://www.example.com/"));
+  EXPECT_EQ("https://example.com/path?q=1",
+            rule_set->Apply("http://example.com/path?q=1"));
+  EXPECT_EQ("", rule_set->Apply("http://other.com/"));
+}
+
+TEST(HTTPSERuleSetTest, Exclusion) {
+  auto rule_set = HTTPSERuleSet::Parse(kRules);
+  ASSERT_TRUE(rule_set);
+  EXPECT_EQ("", rule_set->Apply("http://www.example.com/no-https/page"));
+}
+
+TEST(HTTPSERuleSetTest, UpgradeScheme) {
+  auto rule_set = HTTPSERuleSet::Parse(kUpgradeRules);
+  ASSERT_TRUE(rule_set);
+  EXPECT_EQ("https://anything.com/", rule_set->Apply("http://anything.com/"));
+}
+
+TEST(HTTPSERuleSetTest, TargetWithoutRulesStopsEvaluation) {
+  auto rule_set = HTTPSERuleSet::Parse(kTargetWithoutRules);
+  ASSERT_TRUE(rule_set);
+  EXPECT_EQ("", rule_set->Apply("http://anything.com/"));
+}
+
+TEST(HTTPSERuleSetTest, CorrectToRuleForRE2) {
+  EXPECT_EQ("https://\\1example.com/\\2",
+            HTTPSERuleSet::CorrectToRuleForRE2("https://$1example.com/$2"));
+}
+
+TEST(HTTPSERuleSetTest, CompiledRuleSetIsReusable) {
+  std::unique_ptr<HTTPSERuleSet> rule_set = HTTPSERuleSet::Parse(kRules);
+  ASSERT_TRUE(rule_set);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ("https://www.example.com/page",
+              rule_set->Apply("http://www.example.com/page"));
+    EXPECT_EQ("", rule_set->Apply("http://www.example.com/no-https/page"));
+  }
+}
+
+// Compares the cost of a recently-used-cache miss before rule sets were
+// compiled (parse and compile on every lookup) with a lookup against a rule
+// set compiled once per key. Disabled as it only logs timings, run it with
+// --gtest_also_run_disabled_tests.
+TEST(HTTPSERuleSetTest, DISABLED_MissLatencyBenchmark) {
+  const int kHosts = 200;
+  const int kIterations = 20;
+
+  std::vector<std::string> rules;
+  std::vector<std::string> urls;
+  for (int i = 0; i < kHosts; ++i) {
+    rules.push_back(base::StringPrintf(
+        R"([{"e": [{"p": "^http://www\\.host%d\\.com/skip/"}],)"
+        R"("r": [{"f": "^http://(www\\.)?host%d\\.com/",)"
+        R"("t": "https://$1host%d.com/"}]}])",
+        i, i, i));
+    urls.push_back(base::StringPrintf("http://www.host%d.com/page", i));
+  }
+
+  base::ElapsedTimer uncompiled_timer;
+  for (int iteration = 0; iteration < kIterations; ++iteration) {
+    for (int i = 0; i < kHosts; ++i) {
+      HTTPSERuleSet::Parse(rules[i])->Apply(urls[i]);
+    }
+  }
+  const base::TimeDelta uncompiled = uncompiled_timer.Elapsed();
+
+  std::vector<std::unique_ptr<HTTPSERuleSet>> compiled_rules;
+  for (const auto& rule : rules) {
+    compiled_rules.push_back(HTTPSERuleSet::Parse(rule));
+  }
+  base::ElapsedTimer compiled_timer;
+  for (int iteration = 0; iteration < kIterations; ++iteration) {
+    for (int i = 0; i < kHosts; ++i) {
+      compiled_rules[i]->Apply(urls[i]);
+    }
+  }
+  const base::TimeDelta compiled = compiled_timer.Elapsed();
+
+  const int lookups = kHosts * kIterations;
+  LOG(INFO) << "HTTPSE miss latency over " << lookups << " lookups: "
+            << "parse and compile per lookup "
+            << uncompiled.InMicrosecondsF() / lookups << "us, "
+            << "precompiled " << compiled.InMicrosecondsF() / lookups << "us";
+}
+
+}  // namespace brave_shields
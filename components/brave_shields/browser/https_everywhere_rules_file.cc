@@ -0,0 +1,128 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rules_file.h"
+
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+
+namespace brave_shields {
+
+namespace {
+
+const char kMagic[] = "HSE1";
+constexpr size_t kMagicSize = 4;
+constexpr size_t kHeaderSize = kMagicSize + sizeof(uint32_t);
+constexpr size_t kEntrySize = 4 * sizeof(uint32_t);
+
+uint32_t ReadUInt32(const uint8_t* data) {
+  return static_cast<uint32_t>(data[0]) |
+         static_cast<uint32_t>(data[1]) << 8 |
+         static_cast<uint32_t>(data[2]) << 16 |
+         static_cast<uint32_t>(data[3]) << 24;
+}
+
+void AppendUInt32(uint32_t value, std::string* out) {
+  for (int i = 0; i < 4; ++i) {
+    out->push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+}  // namespace
+
+HTTPSERulesFile::HTTPSERulesFile() = default;
+HTTPSERulesFile::~HTTPSERulesFile() = default;
+
+// static
+std::unique_ptr<HTTPSERulesFile> HTTPSERulesFile::Open(
+    const base::FilePath& path) {
+  auto rules_file = base::WrapUnique(new HTTPSERulesFile());
+  if (!rules_file->Initialize(path)) {
+    return nullptr;
+  }
+  return rules_file;
+}
+
+bool HTTPSERulesFile::Initialize(const base::FilePath& path) {
+  if (!file_.Initialize(path)) {
+    LOG(ERROR) << "Failed to map HTTPSE rules file " << path.value();
+    return false;
+  }
+
+  const uint8_t* data = file_.data();
+  const size_t length = file_.length();
+  if (length < kHeaderSize ||
+      std::string(reinterpret_cast<const char*>(data), kMagicSize) != kMagic) {
+    LOG(ERROR) << "Invalid HTTPSE rules file header " << path.value();
+    return false;
+  }
+
+  entry_count_ = ReadUInt32(data + kMagicSize);
+  const size_t available = length - kHeaderSize;
+  if (entry_count_ > available / kEntrySize) {
+    LOG(ERROR) << "Truncated HTTPSE rules file " << path.value();
+    return false;
+  }
+
+  entries_ = data + kHeaderSize;
+  blob_ = entries_ + entry_count_ * kEntrySize;
+  blob_size_ = available - entry_count_ * kEntrySize;
+  return true;
+}
+
+base::StringPiece HTTPSERulesFile::GetString(
+    const uint8_t* entry_field) const {
+  const uint32_t offset = ReadUInt32(entry_field);
+  const uint32_t size = ReadUInt32(entry_field + sizeof(uint32_t));
+  // Entries are bounds checked on use so opening the file stays O(1).
+  if (offset > blob_size_ || size > blob_size_ - offset) {
+    return base::StringPiece();
+  }
+  return base::StringPiece(reinterpret_cast<const char*>(blob_ + offset),
+                           size);
+}
+
+base::StringPiece HTTPSERulesFile::Find(base::StringPiece key) const {
+  size_t low = 0;
+  size_t high = entry_count_;
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    const uint8_t* entry = entries_ + middle * kEntrySize;
+    const int result = GetString(entry).compare(key);
+    if (result == 0) {
+      return GetString(entry + 2 * sizeof(uint32_t));
+    }
+    if (result < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return base::StringPiece();
+}
+
+// static
+std::string HTTPSERulesFile::Serialize(
+    const std::map<std::string, std::string>& rules) {
+  std::string entries;
+  std::string blob;
+  for (const auto& rule : rules) {
+    AppendUInt32(blob.size(), &entries);
+    AppendUInt32(rule.first.size(), &entries);
+    blob.append(rule.first);
+    AppendUInt32(blob.size(), &entries);
+    AppendUInt32(rule.second.size(), &entries);
+    blob.append(rule.second);
+  }
+
+  std::string out(kMagic, kMagicSize);
+  AppendUInt32(rules.size(), &out);
+  out.append(entries);
+  out.append(blob);
+  return out;
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,61 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULES_FILE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULES_FILE_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/files/memory_mapped_file.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+class FilePath;
+}  // namespace base
+
+namespace brave_shields {
+
+// Read-only view over the binary HTTPS Everywhere rules file, which replaces
+// the zipped LevelDB database for newer component versions. The file is
+// memory mapped, so opening it does no unzipping and no parsing.
+//
+// Layout, all integers are little-endian uint32:
+//   header:  magic "HSE1", entry count
+//   entries: |entry count| x (key offset, key length, value offset,
+//            value length), sorted by key, offsets relative to the blob
+//   blob:    packed keys and JSON rule values
+class HTTPSERulesFile {
+ public:
+  ~HTTPSERulesFile();
+
+  // Returns nullptr if the file can't be mapped or its header is invalid.
+  static std::unique_ptr<HTTPSERulesFile> Open(const base::FilePath& path);
+
+  // Builds the file contents for |rules|, keyed by reversed domain. Only used
+  // by tests, the component is expected to ship the file prebuilt.
+  static std::string Serialize(const std::map<std::string, std::string>& rules);
+
+  // Returns the JSON rules stored under |key|, or an empty piece if there
+  // are none.
+  base::StringPiece Find(base::StringPiece key) const;
+
+ private:
+  HTTPSERulesFile();
+
+  bool Initialize(const base::FilePath& path);
+  base::StringPiece GetString(const uint8_t* entry_field) const;
+
+  base::MemoryMappedFile file_;
+  uint32_t entry_count_ = 0;
+  const uint8_t* entries_ = nullptr;
+  const uint8_t* blob_ = nullptr;
+  size_t blob_size_ = 0;
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULES_FILE_H_
@@ -0,0 +1,78 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "brave/components/brave_shields/browser/https_everywhere_rules_file.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+class HTTPSERulesFileTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  base::FilePath WriteRulesFile(const std::string& contents) {
+    base::FilePath path = temp_dir_.GetPath().AppendASCII("httpse.rules");
+    EXPECT_TRUE(base::WriteFile(path, contents));
+    return path;
+  }
+
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(HTTPSERulesFileTest, Find) {
+  std::map<std::string, std::string> rules = {
+      {"com.example", R"([{"r": [{"d": 1}]}])"},
+      {"com.example.*", R"([{"r": []}])"},
+      {"org.brave.www", R"([{"e": []}])"},
+  };
+  auto rules_file =
+      HTTPSERulesFile::Open(WriteRulesFile(HTTPSERulesFile::Serialize(rules)));
+  ASSERT_TRUE(rules_file);
+
+  for (const auto& rule : rules) {
+    EXPECT_EQ(rule.second, rules_file->Find(rule.first));
+  }
+  EXPECT_TRUE(rules_file->Find("com").empty());
+  EXPECT_TRUE(rules_file->Find("com.example.www").empty());
+  EXPECT_TRUE(rules_file->Find("zzz").empty());
+}
+
+TEST_F(HTTPSERulesFileTest, Empty) {
+  auto rules_file =
+      HTTPSERulesFile::Open(WriteRulesFile(HTTPSERulesFile::Serialize({})));
+  ASSERT_TRUE(rules_file);
+  EXPECT_TRUE(rules_file->Find("com.example").empty());
+}
+
+TEST_F(HTTPSERulesFileTest, InvalidFile) {
+  EXPECT_FALSE(HTTPSERulesFile::Open(
+      temp_dir_.GetPath().AppendASCII("does_not_exist")));
+  EXPECT_FALSE(HTTPSERulesFile::Open(WriteRulesFile("HSE")));
+  EXPECT_FALSE(HTTPSERulesFile::Open(
+      WriteRulesFile(std::string("XXXX\x01\0\0\0", 8))));
+
+  // Entry count larger than the file.
+  std::string truncated("HSE1\xff\0\0\0", 8);
+  EXPECT_FALSE(HTTPSERulesFile::Open(WriteRulesFile(truncated)));
+}
+
+TEST_F(HTTPSERulesFileTest, OutOfBoundsEntry) {
+  std::string contents =
+      HTTPSERulesFile::Serialize({{"com.example", "[]"}});
+  // Point the value offset of the only entry past the end of the blob.
+  contents[8 + 8] = '\x7f';
+  auto rules_file = HTTPSERulesFile::Open(WriteRulesFile(contents));
+  ASSERT_TRUE(rules_file);
+  EXPECT_TRUE(rules_file->Find("com.example").empty());
+}
+
+}  // namespace brave_shields
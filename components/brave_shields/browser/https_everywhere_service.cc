@@ -12,39 +12,38 @@
 
 #include "base/base_paths.h"
 #include "base/bind.h"
-#include "base/json/json_reader.h"
+#include "base/files/file_util.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/strings/string_split.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/scoped_blocking_call.h"
-#include "base/values.h"
+#include "base/time/default_tick_clock.h"
+#include "brave/components/brave_shields/browser/https_everywhere_rule_set.h"
+#include "brave/components/brave_shields/browser/https_everywhere_rules_file.h"
 #include "third_party/leveldatabase/src/include/leveldb/db.h"
-#include "third_party/re2/src/re2/re2.h"
 #include "third_party/zlib/google/zip.h"
 
 #define DAT_FILE "httpse.leveldb.zip"
+#define RULES_FILE "httpse.rules"
 #define DAT_FILE_VERSION "6.0"
-#define HTTPSE_URLS_REDIRECTS_COUNT_QUEUE   1
 #define HTTPSE_URL_MAX_REDIRECTS_COUNT      5
+#define HTTPSE_COMPILED_RULE_SETS_CACHE_SIZE 1000
+#define HTTPSE_URL_REDIRECTS_TTL_SECONDS    60
 
 namespace {
 
-std::vector<std::string> Split(const std::string& s, char delim) {
-  std::stringstream ss(s);
-  std::string item;
-  std::vector<std::string> result;
-  while (getline(ss, item, delim)) {
-    result.push_back(item);
-  }
-  return result;
-}
-
 // returns parts in reverse order, makes list of lookup domains like com.foo.*
 std::vector<std::string> ExpandDomainForLookup(const std::string& domain) {
   std::vector<std::string> resultDomains;
-  std::vector<std::string> domainParts = Split(domain, '.');
+  std::vector<base::StringPiece> domainParts = base::SplitStringPiece(
+      domain, ".", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
+  if (!domainParts.empty() && domainParts.back().empty()) {
+    // Drop the empty label of a fully qualified host name
+    domainParts.pop_back();
+  }
   if (domainParts.empty()) {
     return resultDomains;
   }
@@ -54,7 +53,8 @@ std::vector<std::string> ExpandDomainForLookup(const std::string& domain) {
     std::string slice = "";
     std::string dot = "";
     for (int j = domainParts.size() - 1; j >= static_cast<int>(i); j--) {
-      slice += dot + domainParts[j];
+      slice += dot;
+      slice.append(domainParts[j].data(), domainParts[j].size());
       dot = ".";
     }
     if (0 != i) {
@@ -101,12 +101,20 @@ HTTPSEverywhereService::g_https_everywhere_component_base64_public_key_(
 HTTPSEverywhereService::HTTPSEverywhereService(
     BraveComponent::Delegate* delegate)
     : BaseBraveShieldsService(delegate),
+      redirect_tracker_(
+          HTTPSE_URL_MAX_REDIRECTS_COUNT,
+          base::TimeDelta::FromSeconds(HTTPSE_URL_REDIRECTS_TTL_SECONDS),
+          base::DefaultTickClock::GetInstance()),
+      rule_sets_cache_(HTTPSE_COMPILED_RULE_SETS_CACHE_SIZE),
       level_db_(nullptr) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
 HTTPSEverywhereService::~HTTPSEverywhereService() {
   GetTaskRunner()->DeleteSoon(FROM_HERE, level_db_);
+  if (rules_file_) {
+    GetTaskRunner()->DeleteSoon(FROM_HERE, std::move(rules_file_));
+  }
 }
 
 bool HTTPSEverywhereService::Init() {
@@ -118,6 +126,20 @@ bool HTTPSEverywhereService::Init() {
 
 void HTTPSEverywhereService::InitDB(const base::FilePath& install_dir) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // A binary rules file in the component is mapped as is. No component
+  // version ships one yet, so until then the zipped LevelDB database is used.
+  base::FilePath rules_file_path =
+      install_dir.AppendASCII(DAT_FILE_VERSION).AppendASCII(RULES_FILE);
+  if (base::PathExists(rules_file_path)) {
+    std::unique_ptr<HTTPSERulesFile> rules_file =
+        HTTPSERulesFile::Open(rules_file_path);
+    if (rules_file) {
+      CloseDatabase();
+      rules_file_ = std::move(rules_file);
+      return;
+    }
+  }
+
   base::FilePath zip_db_file_path =
       install_dir.AppendASCII(DAT_FILE_VERSION).AppendASCII(DAT_FILE);
   base::FilePath unzipped_level_db_path = zip_db_file_path.RemoveExtension();
@@ -162,14 +184,15 @@ bool HTTPSEverywhereService::GetHTTPSURL(
   if (!url->is_valid())
     return false;
 
-  if (!IsInitialized() || !level_db_ || url->scheme() == url::kHttpsScheme) {
+  if (!IsInitialized() || (!level_db_ && !rules_file_) ||
+      url->scheme() == url::kHttpsScheme) {
     return false;
   }
   if (!ShouldHTTPSERedirect(request_identifier)) {
     return false;
   }
 
-  if (recently_used_cache_.get(url->spec(), new_url)) {
+  if (recently_used_cache_.Get(url->spec(), new_url)) {
     AddHTTPSEUrlToRedirectList(request_identifier);
     return true;
   }
@@ -184,18 +207,18 @@ bool HTTPSEverywhereService::GetHTTPSURL(
   SCOPED_UMA_HISTOGRAM_TIMER("Brave.HTTPSE.GetHTTPSURL");
   const std::vector<std::string> domains =
       ExpandDomainForLookup(candidate_url.host());
-  for (auto domain : domains) {
-    std::string value = leveldbGet(level_db_, domain);
-    if (!value.empty()) {
-      *new_url = ApplyHTTPSRule(candidate_url.spec(), value);
+  for (const auto& domain : domains) {
+    const HTTPSERuleSet* rule_set = GetRuleSet(domain);
+    if (rule_set) {
+      *new_url = rule_set->Apply(candidate_url.spec());
       if (0 != new_url->length()) {
-        recently_used_cache_.add(candidate_url.spec(), *new_url);
+        recently_used_cache_.Put(candidate_url.spec(), *new_url);
         AddHTTPSEUrlToRedirectList(request_identifier);
         return true;
       }
     }
   }
-  recently_used_cache_.remove(candidate_url.spec());
+  recently_used_cache_.Erase(candidate_url.spec());
   return false;
 }
 
@@ -213,7 +236,7 @@ bool HTTPSEverywhereService::GetHTTPSURLFromCacheOnly(
     return false;
   }
 
-  if (recently_used_cache_.get(url->spec(), cached_url)) {
+  if (recently_used_cache_.Get(url->spec(), cached_url)) {
     AddHTTPSEUrlToRedirectList(request_identifier);
     return true;
   }
@@ -222,160 +245,43 @@ bool HTTPSEverywhereService::GetHTTPSURLFromCacheOnly(
 
 bool HTTPSEverywhereService::ShouldHTTPSERedirect(
     const uint64_t& request_identifier) {
-  base::AutoLock auto_lock(httpse_get_urls_redirects_count_mutex_);
-  for (size_t i = 0; i < httpse_urls_redirects_count_.size(); i++) {
-    if (request_identifier ==
-        httpse_urls_redirects_count_[i].request_identifier_ &&
-        httpse_urls_redirects_count_[i].redirects_ >=
-        HTTPSE_URL_MAX_REDIRECTS_COUNT - 1) {
-      return false;
-    }
-  }
-
-  return true;
+  return redirect_tracker_.ShouldRedirect(request_identifier);
 }
 
 void HTTPSEverywhereService::AddHTTPSEUrlToRedirectList(
     const uint64_t& request_identifier) {
   // Adding redirects count for the current request
-  base::AutoLock auto_lock(httpse_get_urls_redirects_count_mutex_);
-  bool hostFound = false;
-  for (size_t i = 0; i < httpse_urls_redirects_count_.size(); i++) {
-    if (request_identifier ==
-        httpse_urls_redirects_count_[i].request_identifier_) {
-      // Found the host, just increment the redirects_count
-      httpse_urls_redirects_count_[i].redirects_++;
-      hostFound = true;
-      break;
-    }
-  }
-  if (!hostFound) {
-      // The host is new, adding it to the redirects list
-      if (httpse_urls_redirects_count_.size() >=
-          HTTPSE_URLS_REDIRECTS_COUNT_QUEUE) {
-          // The queue is full, erase the first element
-          httpse_urls_redirects_count_.erase(
-              httpse_urls_redirects_count_.begin());
-      }
-      httpse_urls_redirects_count_.push_back(
-          HTTPSE_REDIRECTS_COUNT_ST(request_identifier, 1));
-  }
+  redirect_tracker_.AddRedirect(request_identifier);
 }
 
-std::string HTTPSEverywhereService::ApplyHTTPSRule(
-    const std::string& originalUrl,
-    const std::string& rule) {
-  absl::optional<base::Value> json_object = base::JSONReader::Read(rule);
-  if (absl::nullopt == json_object || !json_object->is_list()) {
-    return "";
+const HTTPSERuleSet* HTTPSEverywhereService::GetRuleSet(
+    const std::string& domain) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = rule_sets_cache_.Get(domain);
+  if (it != rule_sets_cache_.end()) {
+    return it->second.get();
   }
 
-  base::Value::ConstListView topValues = json_object->GetList();
-  for (auto it = topValues.cbegin(); it != topValues.cend(); ++it) {
-    if (!it->is_dict()) {
-      continue;
-    }
-    const base::DictionaryValue* childTopDictionary = nullptr;
-    it->GetAsDictionary(&childTopDictionary);
-    if (nullptr == childTopDictionary) {
-      continue;
-    }
-
-    const base::Value* exclusion = nullptr;
-    if (childTopDictionary->Get("e", &exclusion)) {
-      const base::ListValue* eValues = nullptr;
-      exclusion->GetAsList(&eValues);
-      if (nullptr != eValues) {
-        for (size_t j = 0; j < eValues->GetList().size(); ++j) {
-          const base::Value* pValue = nullptr;
-          if (!eValues->Get(j, &pValue)) {
-            continue;
-          }
-          const base::DictionaryValue* pDictionary = nullptr;
-          pValue->GetAsDictionary(&pDictionary);
-          if (nullptr == pDictionary) {
-            continue;
-          }
-          const base::Value* patternValue = nullptr;
-          if (!pDictionary->Get("p", &patternValue)) {
-            continue;
-          }
-          std::string pattern;
-          if (!patternValue->GetAsString(&pattern)) {
-            continue;
-          }
-          pattern = CorrecttoRuleToRE2Engine(pattern);
-          if (RE2::FullMatch(originalUrl, pattern)) {
-            return "";
-          }
-        }
-      }
-    }
-
-    const base::Value* rules = nullptr;
-    if (!childTopDictionary->Get("r", &rules)) {
-      return "";
-    }
-    const base::ListValue* rValues = nullptr;
-    rules->GetAsList(&rValues);
-    if (nullptr == rValues) {
-      return "";
-    }
-
-    for (size_t j = 0; j < rValues->GetList().size(); ++j) {
-      const base::Value* pValue = nullptr;
-      if (!rValues->Get(j, &pValue)) {
-        continue;
-      }
-      const base::DictionaryValue* pDictionary = nullptr;
-      pValue->GetAsDictionary(&pDictionary);
-      if (nullptr == pDictionary) {
-        continue;
-      }
-      const base::Value* patternValue = nullptr;
-      if (pDictionary->Get("d", &patternValue)) {
-        std::string newUrl(originalUrl);
-        return newUrl.insert(4, "s");
-      }
-
-      const base::Value* from_value = nullptr;
-      const base::Value* to_value = nullptr;
-      if (!pDictionary->Get("f", &from_value) ||
-          !pDictionary->Get("t", &to_value)) {
-        continue;
-      }
-      std::string from, to;
-      if (!from_value->GetAsString(&from) ||
-          !to_value->GetAsString(&to)) {
-        continue;
-      }
-
-      to = CorrecttoRuleToRE2Engine(to);
-      std::string newUrl(originalUrl);
-      RE2 regExp(from);
-
-      if (RE2::Replace(&newUrl, regExp, to) && newUrl != originalUrl) {
-        return newUrl;
-      }
-    }
+  // Keys without rules are cached as well, so repeated misses for the same
+  // host don't go back to the database either.
+  std::unique_ptr<HTTPSERuleSet> rule_set;
+  std::string value;
+  if (rules_file_) {
+    value = std::string(rules_file_->Find(domain));
+  } else {
+    value = leveldbGet(level_db_, domain);
   }
-  return "";
-}
-
-std::string HTTPSEverywhereService::CorrecttoRuleToRE2Engine(
-    const std::string& to) {
-  std::string correctedto(to);
-  size_t pos = to.find("$");
-  while (std::string::npos != pos) {
-    correctedto[pos] = '\\';
-    pos = correctedto.find("$");
+  if (!value.empty()) {
+    rule_set = HTTPSERuleSet::Parse(value);
   }
-
-  return correctedto;
+  it = rule_sets_cache_.Put(domain, std::move(rule_set));
+  return it->second.get();
 }
 
 void HTTPSEverywhereService::CloseDatabase() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  rule_sets_cache_.Clear();
+  rules_file_.reset();
   if (level_db_) {
     delete level_db_;
     level_db_ = nullptr;
@@ -8,14 +8,14 @@
 
 #include <memory>
 #include <string>
-#include <vector>
 
+#include "base/containers/lru_cache.h"
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
-#include "base/synchronization/lock.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "brave/components/brave_shields/browser/https_everywhere_recently_used_cache.h"
+#include "brave/components/brave_shields/browser/https_everywhere_redirect_tracker.h"
 
 namespace leveldb {
 class DB;
@@ -27,22 +27,13 @@ using brave_component_updater::BraveComponent;
 
 namespace brave_shields {
 
+class HTTPSERuleSet;
+class HTTPSERulesFile;
+
 extern const char kHTTPSEverywhereComponentName[];
 extern const char kHTTPSEverywhereComponentId[];
 extern const char kHTTPSEverywhereComponentBase64PublicKey[];
 
-struct HTTPSE_REDIRECTS_COUNT_ST {
- public:
-  HTTPSE_REDIRECTS_COUNT_ST(uint64_t request_identifier,
-                            unsigned int redirects):
-    request_identifier_(request_identifier),
-    redirects_(redirects) {
-  }
-
-  uint64_t request_identifier_;
-  unsigned int redirects_;
-};
-
 class HTTPSEverywhereService : public BaseBraveShieldsService,
                          public base::SupportsWeakPtr<HTTPSEverywhereService> {
  public:
@@ -63,9 +54,6 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
 
   void AddHTTPSEUrlToRedirectList(const uint64_t& request_id);
   bool ShouldHTTPSERedirect(const uint64_t& request_id);
-  std::string ApplyHTTPSRule(const std::string& originalUrl,
-      const std::string& rule);
-  std::string CorrecttoRuleToRE2Engine(const std::string& to);
 
  private:
   friend class ::HTTPSEverywhereServiceTest;
@@ -77,13 +65,18 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
       const std::string& component_id,
       const std::string& component_base64_public_key);
 
+  // Returns the compiled rules stored under |domain|, loading and compiling
+  // them on a cache miss. Returns nullptr if there are no rules for |domain|.
+  const HTTPSERuleSet* GetRuleSet(const std::string& domain);
   void CloseDatabase();
 
   void InitDB(const base::FilePath& install_dir);
 
-  base::Lock httpse_get_urls_redirects_count_mutex_;
-  std::vector<HTTPSE_REDIRECTS_COUNT_ST> httpse_urls_redirects_count_;
+  HTTPSERedirectTracker redirect_tracker_;
   HTTPSERecentlyUsedCache<std::string> recently_used_cache_;
+  // Keyed by the reversed-domain database key, only used on the task runner.
+  base::LRUCache<std::string, std::unique_ptr<HTTPSERuleSet>> rule_sets_cache_;
+  std::unique_ptr<HTTPSERulesFile> rules_file_;
   leveldb::DB* level_db_;
 
   SEQUENCE_CHECKER(sequence_checker_);
@@ -0,0 +1,196 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHARDED_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHARDED_CACHE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/check_op.h"
+#include "base/synchronization/lock.h"
+
+namespace brave_shields {
+
+// Fixed-size cache safe to use from any thread, meant for hot Shields
+// lookups (HTTPSE, ad-block, debounce) that are hit from both the IO thread
+// and the thread pool. Keys are hashed to pick one of several independently
+// locked shards, so concurrent lookups of different keys rarely wait on each
+// other. Each shard evicts with the CLOCK algorithm, which only needs to set
+// a reference bit on a hit instead of relinking an LRU list.
+template <class T>
+class ShardedCache {
+ public:
+  static constexpr size_t kDefaultShardCount = 16;
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // Number of times a shard lock was already held by another thread.
+    uint64_t contentions = 0;
+  };
+
+  explicit ShardedCache(size_t capacity = 100,
+                        size_t shard_count = kDefaultShardCount) {
+    DCHECK_GT(capacity, 0u);
+    DCHECK_GT(shard_count, 0u);
+    shard_count = std::min(shard_count, capacity);
+    const size_t shard_capacity = (capacity + shard_count - 1) / shard_count;
+    for (size_t i = 0; i < shard_count; ++i) {
+      shards_.push_back(std::make_unique<Shard>(shard_capacity));
+    }
+  }
+  ShardedCache(const ShardedCache&) = delete;
+  ShardedCache& operator=(const ShardedCache&) = delete;
+
+  void Put(const std::string& key, const T& value) {
+    const size_t hash = Hash(key);
+    Shard& shard = GetShard(hash);
+    base::AutoLock lock(Acquire(&shard), base::AutoLock::AlreadyAcquired());
+    auto it = shard.index.find(hash);
+    if (it != shard.index.end()) {
+      // Either the same key or a hash collision, in both cases the newest
+      // entry wins.
+      Slot& slot = shard.slots[it->second];
+      slot.key = key;
+      slot.value = value;
+      return;
+    }
+
+    const size_t slot_index = shard.FindVictim();
+    Slot& slot = shard.slots[slot_index];
+    if (slot.used) {
+      shard.index.erase(slot.hash);
+    }
+    slot.used = true;
+    // New entries have to be hit once before they survive a sweep.
+    slot.referenced = false;
+    slot.hash = hash;
+    slot.key = key;
+    slot.value = value;
+    shard.index[hash] = slot_index;
+  }
+
+  bool Get(const std::string& key, T* value) {
+    const size_t hash = Hash(key);
+    Shard& shard = GetShard(hash);
+    base::AutoLock lock(Acquire(&shard), base::AutoLock::AlreadyAcquired());
+    auto it = shard.index.find(hash);
+    if (it == shard.index.end() || shard.slots[it->second].key != key) {
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    Slot& slot = shard.slots[it->second];
+    slot.referenced = true;
+    *value = slot.value;
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void Erase(const std::string& key) {
+    const size_t hash = Hash(key);
+    Shard& shard = GetShard(hash);
+    base::AutoLock lock(Acquire(&shard), base::AutoLock::AlreadyAcquired());
+    auto it = shard.index.find(hash);
+    if (it == shard.index.end() || shard.slots[it->second].key != key) {
+      return;
+    }
+    shard.slots[it->second] = Slot();
+    shard.free_slots.push_back(it->second);
+    shard.index.erase(it);
+  }
+
+  void Clear() {
+    for (auto& shard : shards_) {
+      base::AutoLock lock(Acquire(shard.get()),
+                          base::AutoLock::AlreadyAcquired());
+      shard->Reset();
+    }
+  }
+
+  Stats GetStats() const {
+    Stats stats;
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+    stats.contentions = contentions_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+ private:
+  struct Slot {
+    bool used = false;
+    bool referenced = false;
+    size_t hash = 0;
+    std::string key;
+    T value = T();
+  };
+
+  struct Shard {
+    explicit Shard(size_t capacity) : slots(capacity) { Reset(); }
+
+    void Reset() {
+      std::fill(slots.begin(), slots.end(), Slot());
+      index.clear();
+      free_slots.clear();
+      for (size_t i = slots.size(); i > 0; --i) {
+        free_slots.push_back(i - 1);
+      }
+      hand = 0;
+    }
+
+    // Returns the slot to fill next: a free one if there is any, otherwise
+    // the first unreferenced slot after the clock hand.
+    size_t FindVictim() {
+      if (!free_slots.empty()) {
+        const size_t free_slot = free_slots.back();
+        free_slots.pop_back();
+        return free_slot;
+      }
+      while (true) {
+        const size_t current = hand;
+        hand = (hand + 1) % slots.size();
+        Slot& slot = slots[current];
+        if (!slot.referenced) {
+          return current;
+        }
+        slot.referenced = false;
+      }
+    }
+
+    base::Lock lock;
+    std::vector<Slot> slots;
+    std::unordered_map<size_t, size_t> index;
+    std::vector<size_t> free_slots;
+    size_t hand = 0;
+  };
+
+  static size_t Hash(const std::string& key) {
+    return std::hash<std::string>()(key);
+  }
+
+  Shard& GetShard(size_t hash) { return *shards_[hash % shards_.size()]; }
+
+  base::Lock& Acquire(Shard* shard) {
+    if (!shard->lock.Try()) {
+      contentions_.fetch_add(1, std::memory_order_relaxed);
+      shard->lock.Acquire();
+    }
+    return shard->lock;
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> contentions_{0};
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHARDED_CACHE_H_
@@ -0,0 +1,151 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task/thread_pool.h"
+#include "base/test/task_environment.h"
+#include "base/threading/thread.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/components/brave_shields/browser/sharded_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr int kKeys = 2000;
+constexpr int kThreadPoolWorkers = 4;
+
+void HammerCache(ShardedCache<std::string>* cache, int operations, int seed) {
+  std::string value;
+  for (int i = 0; i < operations; ++i) {
+    const std::string key =
+        "https://host" + base::NumberToString((i * 7 + seed) % kKeys) + "/";
+    if (!cache->Get(key, &value)) {
+      cache->Put(key, key);
+    } else {
+      EXPECT_EQ(key, value);
+    }
+  }
+}
+
+// Runs |HammerCache()| on a dedicated IO-like thread and the thread pool at
+// the same time.
+void HammerCacheConcurrently(base::test::TaskEnvironment* task_environment,
+                             ShardedCache<std::string>* cache,
+                             int operations) {
+  base::Thread io_thread("IO");
+  ASSERT_TRUE(io_thread.Start());
+
+  io_thread.task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(&HammerCache, cache, operations, 0));
+  for (int i = 1; i <= kThreadPoolWorkers; ++i) {
+    base::ThreadPool::PostTask(
+        FROM_HERE, base::BindOnce(&HammerCache, cache, operations, i));
+  }
+  task_environment->RunUntilIdle();
+  io_thread.Stop();
+}
+
+}  // namespace
+
+TEST(ShardedCacheTest, Stats) {
+  ShardedCache<int> cache(10);
+  int value = 0;
+  EXPECT_FALSE(cache.Get("a", &value));
+  cache.Put("a", 1);
+  EXPECT_TRUE(cache.Get("a", &value));
+  EXPECT_EQ(1, value);
+
+  const auto stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_EQ(0u, stats.contentions);
+}
+
+TEST(ShardedCacheTest, ErasedSlotIsReusedBeforeEviction) {
+  ShardedCache<int> cache(2, 1);
+  cache.Put("a", 1);
+  cache.Put("b", 2);
+  cache.Erase("a");
+  cache.Put("c", 3);
+
+  int value = 0;
+  EXPECT_FALSE(cache.Get("a", &value));
+  EXPECT_TRUE(cache.Get("b", &value));
+  EXPECT_EQ(2, value);
+  EXPECT_TRUE(cache.Get("c", &value));
+  EXPECT_EQ(3, value);
+}
+
+TEST(ShardedCacheTest, Overwrite) {
+  ShardedCache<int> cache(2, 1);
+  cache.Put("a", 1);
+  cache.Put("a", 2);
+  cache.Put("b", 3);
+
+  int value = 0;
+  EXPECT_TRUE(cache.Get("a", &value));
+  EXPECT_EQ(2, value);
+  EXPECT_TRUE(cache.Get("b", &value));
+}
+
+TEST(ShardedCacheTest, Clear) {
+  ShardedCache<int> cache(10);
+  cache.Put("a", 1);
+  cache.Put("b", 2);
+  cache.Clear();
+
+  int value = 0;
+  EXPECT_FALSE(cache.Get("a", &value));
+  EXPECT_FALSE(cache.Get("b", &value));
+  cache.Put("a", 3);
+  EXPECT_TRUE(cache.Get("a", &value));
+  EXPECT_EQ(3, value);
+}
+
+TEST(ShardedCacheTest, ConcurrentAccess) {
+  base::test::TaskEnvironment task_environment;
+  constexpr int kOperationsPerThread = 20000;
+
+  for (size_t shard_count : {size_t{1}, ShardedCache<int>::kDefaultShardCount}) {
+    ShardedCache<std::string> cache(kKeys / 2, shard_count);
+    HammerCacheConcurrently(&task_environment, &cache, kOperationsPerThread);
+
+    const auto stats = cache.GetStats();
+    EXPECT_EQ(static_cast<uint64_t>(kOperationsPerThread) *
+                  (kThreadPoolWorkers + 1),
+              stats.hits + stats.misses);
+  }
+}
+
+// Hammers the cache from a dedicated IO-like thread and the thread pool at
+// the same time, once with a single shard (the behavior of the old
+// single-lock cache) and once with the default shard count. Disabled as it
+// only logs timings, run it with --gtest_also_run_disabled_tests.
+TEST(ShardedCacheTest, DISABLED_MultiThreadedBenchmark) {
+  base::test::TaskEnvironment task_environment;
+  constexpr int kOperationsPerThread = 200000;
+
+  for (size_t shard_count : {size_t{1}, ShardedCache<int>::kDefaultShardCount}) {
+    ShardedCache<std::string> cache(kKeys / 2, shard_count);
+
+    base::ElapsedTimer timer;
+    HammerCacheConcurrently(&task_environment, &cache, kOperationsPerThread);
+    const base::TimeDelta elapsed = timer.Elapsed();
+
+    const auto stats = cache.GetStats();
+    LOG(INFO) << "ShardedCache with " << shard_count << " shard(s): "
+              << elapsed.InMilliseconds() << "ms, " << stats.hits
+              << " hits, " << stats.misses << " misses, " << stats.contentions
+              << " contentions";
+  }
+}
+
+}  // namespace brave_shields
@@ -34,6 +34,10 @@ const base::Feature kBraveAdblockCosmeticFiltering{
     base::FEATURE_ENABLED_BY_DEFAULT};
 const base::Feature kBraveAdblockCspRules{
     "BraveAdblockCspRules", base::FEATURE_ENABLED_BY_DEFAULT};
+// When enabled, Brave will match requests against all enabled filter list
+// subscriptions with a single merged engine instead of one engine per list.
+const base::Feature kBraveAdblockMergedSubscriptions{
+    "BraveAdblockMergedSubscriptions", base::FEATURE_DISABLED_BY_DEFAULT};
 // When enabled, Brave will block domains listed in the user's selected adblock
 // filters and present a security interstitial with choice to proceed and
 // optionally whitelist the domain.
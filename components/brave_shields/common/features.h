@@ -18,6 +18,7 @@ extern const base::Feature kBraveAdblockCollapseBlockedElements;
 extern const base::Feature kBraveAdblockCookieListDefault;
 extern const base::Feature kBraveAdblockCosmeticFiltering;
 extern const base::Feature kBraveAdblockCspRules;
+extern const base::Feature kBraveAdblockMergedSubscriptions;
 extern const base::Feature kBraveDomainBlock;
 extern const base::Feature kBraveDomainBlock1PES;
 extern const base::Feature kBraveExtensionNetworkBlocking;
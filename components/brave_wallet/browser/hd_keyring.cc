@@ -51,11 +51,19 @@ void HDKeyring::AddAccounts(size_t number) {
   size_t cur_accounts_number = accounts_.size();
   for (size_t i = cur_accounts_number; i < cur_accounts_number + number; ++i) {
     if (root_) {
-      accounts_.push_back(root_->DeriveChild(i));
+      AddDerivedAccount(root_->DeriveChild(i));
     }
   }
 }
 
+void HDKeyring::AddDerivedAccount(std::unique_ptr<HDKey> hd_key) {
+  const std::string address = GetAddressInternal(hd_key.get());
+  if (!address.empty())
+    account_indices_[address] = accounts_.size();
+  account_addresses_.push_back(address);
+  accounts_.push_back(std::move(hd_key));
+}
+
 std::vector<std::string> HDKeyring::GetAccounts() const {
   std::vector<std::string> addresses;
   for (size_t i = 0; i < accounts_.size(); ++i) {
@@ -66,12 +74,10 @@ std::vector<std::string> HDKeyring::GetAccounts() const {
 
 absl::optional<size_t> HDKeyring::GetAccountIndex(
     const std::string& address) const {
-  for (size_t i = 0; i < accounts_.size(); ++i) {
-    if (GetAddress(i) == address) {
-      return i;
-    }
-  }
-  return absl::nullopt;
+  const auto iter = account_indices_.find(address);
+  if (iter == account_indices_.end())
+    return absl::nullopt;
+  return iter->second;
 }
 
 size_t HDKeyring::GetAccountsNumber() const {
@@ -79,19 +85,19 @@ size_t HDKeyring::GetAccountsNumber() const {
 }
 
 void HDKeyring::RemoveAccount() {
+  account_indices_.erase(account_addresses_.back());
+  account_addresses_.pop_back();
   accounts_.pop_back();
 }
 
 bool HDKeyring::AddImportedAddress(const std::string& address,
                                    std::unique_ptr<HDKey> hd_key) {
   // Account already exists
-  if (imported_accounts_[address])
+  if (imported_accounts_.contains(address))
     return false;
   // Check if it is duplicate in derived accounts
-  for (size_t i = 0; i < accounts_.size(); ++i) {
-    if (GetAddress(i) == address)
-      return false;
-  }
+  if (account_indices_.contains(address))
+    return false;
 
   imported_accounts_[address] = std::move(hd_key);
   return true;
@@ -121,7 +127,7 @@ bool HDKeyring::RemoveImportedAccount(const std::string& address) {
 std::string HDKeyring::GetAddress(size_t index) const {
   if (accounts_.empty() || index >= accounts_.size())
     return std::string();
-  return GetAddressInternal(accounts_[index].get());
+  return account_addresses_[index];
 }
 
 std::string HDKeyring::GetAddressInternal(const HDKey* hd_key) const {
@@ -226,10 +232,9 @@ HDKey* HDKeyring::GetHDKeyFromAddress(const std::string& address) {
   const auto imported_accounts_iter = imported_accounts_.find(address);
   if (imported_accounts_iter != imported_accounts_.end())
     return imported_accounts_iter->second.get();
-  for (size_t i = 0; i < accounts_.size(); ++i) {
-    if (GetAddress(i) == address)
-      return accounts_[i].get();
-  }
+  const auto account_indices_iter = account_indices_.find(address);
+  if (account_indices_iter != account_indices_.end())
+    return accounts_[account_indices_iter->second].get();
   return nullptr;
 }
 
@@ -45,7 +45,8 @@ class HDKeyring {
   size_t GetImportedAccountsNumber() const;
   bool RemoveImportedAccount(const std::string& address);
 
-  // Bitcoin keyring can override this for different address calculation
+  // Returns the address cached when the account was derived. Bitcoin keyring
+  // can override this for different address calculation
   virtual std::string GetAddress(size_t index) const;
 
   // TODO(darkdh): Abstract Transacation class
@@ -72,10 +73,17 @@ class HDKeyring {
   std::string GetAddressInternal(const HDKey* hd_key) const;
   bool AddImportedAddress(const std::string& address,
                           std::unique_ptr<HDKey> hd_key);
+  // Appends a derived account and caches its address.
+  void AddDerivedAccount(std::unique_ptr<HDKey> hd_key);
 
   std::unique_ptr<HDKey> root_;
   std::unique_ptr<HDKey> master_key_;
   std::vector<std::unique_ptr<HDKey>> accounts_;
+  // Addresses of |accounts_|, so the public key and its hash are computed only
+  // once per account.
+  std::vector<std::string> account_addresses_;
+  // (address, index in |accounts_|)
+  base::flat_map<std::string, size_t> account_indices_;
   // (address, key)
   base::flat_map<std::string, std::unique_ptr<HDKey>> imported_accounts_;
 
@@ -61,6 +61,10 @@ TEST(HDKeyringUnitTest, Accounts) {
   keyring.RemoveAccount();
   accounts = keyring.GetAccounts();
   EXPECT_EQ(accounts.size(), 2u);
+  EXPECT_FALSE(
+      keyring.GetAccountIndex("0x02e77f0e2fa06F95BDEa79Fad158477723145838"));
+  EXPECT_FALSE(keyring.GetHDKeyFromAddress(
+      "0x02e77f0e2fa06F95BDEa79Fad158477723145838"));
   EXPECT_EQ(keyring.GetAddress(0),
             "0x2166fB4e11D44100112B1124ac593081519cA1ec");
   EXPECT_EQ(keyring.GetAddress(1),
@@ -112,7 +116,7 @@ TEST(HDKeyringUnitTest, SignMessage) {
   key->SetPrivateKey(private_key);
 
   HDKeyring keyring;
-  keyring.accounts_.push_back(std::move(key));
+  keyring.AddDerivedAccount(std::move(key));
   EXPECT_EQ(keyring.GetAddress(0),
             "0xbE93f9BacBcFFC8ee6663f2647917ed7A20a57BB");
 
@@ -234,4 +238,25 @@ TEST(HDKeyringUnitTest, ImportedAccounts) {
   EXPECT_TRUE(keyring.ImportAccount(private_key).empty());
 }
 
+TEST(HDKeyringUnitTest, ImportDerivedAccount) {
+  HDKeyring keyring;
+  std::vector<uint8_t> seed;
+  EXPECT_TRUE(base::HexStringToBytes(
+      "13ca6c28d26812f82db27908de0b0b7b18940cc4e9d96ebd7de190f706741489907ef65b"
+      "8f9e36c31dc46e81472b6a5e40a4487e725ace445b8203f243fb8958",
+      &seed));
+  keyring.ConstructRootHDKey(seed, "m/44'/60'/0'/0");
+  keyring.AddAccounts(1);
+
+  std::vector<uint8_t> private_key;
+  EXPECT_TRUE(base::HexStringToBytes(
+      "8140cea58e3bebd6174dbc589a7f70e049556233d32e44969d62e51dd0d1189a",
+      &private_key));
+  EXPECT_TRUE(keyring.ImportAccount(private_key).empty());
+  EXPECT_EQ(keyring.GetImportedAccountsNumber(), 0u);
+  EXPECT_EQ(keyring.GetAccountIndex(
+                "0x2166fB4e11D44100112B1124ac593081519cA1ec"),
+            0u);
+}
+
 }  // namespace brave_wallet
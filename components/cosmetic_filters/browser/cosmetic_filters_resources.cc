@@ -7,15 +7,91 @@
 
 #include <utility>
 
-#include "base/json/json_reader.h"
+#include "base/containers/lru_cache.h"
+#include "base/json/json_writer.h"
+#include "base/no_destructor.h"
+#include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "components/content_settings/core/browser/host_content_settings_map.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace cosmetic_filters {
 
+namespace {
+
+// Resources are only looked up once per frame navigation, so a few recent
+// URLs cover the frames of the pages being loaded.
+constexpr size_t kUrlCosmeticResourcesCacheSize = 100;
+
+// Merged resources by URL, shared by the CosmeticFiltersResources of all
+// frames. The URL rather than its host is the key because $generichide
+// exceptions can match on the path.
+struct UrlCosmeticResourcesCache {
+  UrlCosmeticResourcesCache() : entries(kUrlCosmeticResourcesCacheSize) {}
+
+  // The engines version |entries| were merged at.
+  uint64_t engines_version = 0;
+  base::LRUCache<std::string, mojom::UrlCosmeticResourcesPtr> entries;
+};
+
+// Only accessed on the ad-block task runner, where all
+// CosmeticFiltersResources live.
+UrlCosmeticResourcesCache& GetUrlCosmeticResourcesCache() {
+  static base::NoDestructor<UrlCosmeticResourcesCache> cache;
+  return *cache;
+}
+
+std::string WriteJsonList(const base::Value* list) {
+  std::string json;
+  if (!list || list->GetList().empty() ||
+      !base::JSONWriter::Write(*list, &json)) {
+    return std::string();
+  }
+
+  return json;
+}
+
+mojom::UrlCosmeticResourcesPtr ToUrlCosmeticResources(
+    const base::Value& resources) {
+  if (!resources.is_dict()) {
+    return nullptr;
+  }
+
+  auto result = mojom::UrlCosmeticResources::New();
+  result->generichide = resources.FindBoolKey("generichide").value_or(false);
+
+  const base::Value* exceptions = resources.FindListKey("exceptions");
+  if (exceptions) {
+    for (const auto& exception : exceptions->GetList()) {
+      if (exception.is_string()) {
+        result->exceptions.push_back(exception.GetString());
+      }
+    }
+  }
+
+  result->hide_selectors =
+      WriteJsonList(resources.FindListKey("hide_selectors"));
+  result->force_hide_selectors =
+      WriteJsonList(resources.FindListKey("force_hide_selectors"));
+
+  const base::Value* style_selectors = resources.FindDictKey("style_selectors");
+  if (style_selectors) {
+    base::JSONWriter::Write(*style_selectors, &result->style_selectors);
+  }
+
+  const base::Value* injected_script = resources.FindKey("injected_script");
+  if (injected_script) {
+    base::JSONWriter::Write(*injected_script, &result->injected_script);
+  }
+
+  return result;
+}
+
+}  // namespace
+
 CosmeticFiltersResources::CosmeticFiltersResources(
     brave_shields::AdBlockService* ad_block_service)
     : ad_block_service_(ad_block_service) {}
@@ -23,56 +99,57 @@ CosmeticFiltersResources::CosmeticFiltersResources(
 CosmeticFiltersResources::~CosmeticFiltersResources() {}
 
 void CosmeticFiltersResources::HiddenClassIdSelectors(
-    const std::string& input,
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
     const std::vector<std::string>& exceptions,
     HiddenClassIdSelectorsCallback callback) {
-  absl::optional<base::Value> input_value = base::JSONReader::Read(input);
-  if (!input_value || !input_value->is_dict()) {
-    // Nothing to work with
-    std::move(callback).Run(base::Value());
+  TRACE_EVENT2("brave.adblock", "HiddenClassIdSelectors", "classes",
+               classes.size(), "ids", ids.size());
 
-    return;
-  }
-  base::DictionaryValue* input_dict;
-  if (!input_value->GetAsDictionary(&input_dict)) {
-    std::move(callback).Run(base::Value());
+  std::vector<std::string> new_selectors;
 
-    return;
-  }
-  std::vector<std::string> classes;
-  base::ListValue* classes_list;
-  if (input_dict->GetList("classes", &classes_list)) {
-    for (size_t i = 0; i < classes_list->GetList().size(); i++) {
-      if (!classes_list->GetList()[i].is_string()) {
+  auto selectors =
+      ad_block_service_->HiddenClassIdSelectors(classes, ids, exceptions);
+  if (selectors && selectors->is_list()) {
+    for (const auto& selector : selectors->GetList()) {
+      if (!selector.is_string()) {
         continue;
       }
-      classes.push_back(classes_list->GetList()[i].GetString());
-    }
-  }
-  std::vector<std::string> ids;
-  base::ListValue* ids_list;
-  if (input_dict->GetList("ids", &ids_list)) {
-    for (size_t i = 0; i < ids_list->GetList().size(); i++) {
-      if (!ids_list->GetList()[i].is_string()) {
-        continue;
+
+      // The same selector can be matched by several engines or for classes
+      // and ids sent in an earlier batch
+      if (sent_selectors_.insert(selector.GetString()).second) {
+        new_selectors.push_back(selector.GetString());
       }
-      ids.push_back(ids_list->GetList()[i].GetString());
     }
   }
 
-  auto selectors =
-      ad_block_service_->HiddenClassIdSelectors(classes, ids, exceptions);
-
-  std::move(callback).Run(selectors ? std::move(selectors.value())
-                                    : base::Value());
+  std::move(callback).Run(std::move(new_selectors));
 }
 
 void CosmeticFiltersResources::UrlCosmeticResources(
     const std::string& url,
     UrlCosmeticResourcesCallback callback) {
-  auto resources = ad_block_service_->UrlCosmeticResources(url);
-  std::move(callback).Run(resources ? std::move(resources.value())
-                                    : base::Value());
+  // A new page is being loaded in the frame
+  sent_selectors_.clear();
+
+  UrlCosmeticResourcesCache& cache = GetUrlCosmeticResourcesCache();
+  // Read before merging, so a list changed while merging invalidates the
+  // entry on the next call.
+  const uint64_t engines_version = brave_shields::GetAdBlockEnginesVersion();
+  if (cache.engines_version != engines_version) {
+    cache.entries.Clear();
+    cache.engines_version = engines_version;
+  }
+
+  auto it = cache.entries.Get(url);
+  if (it == cache.entries.end()) {
+    auto resources = ad_block_service_->UrlCosmeticResources(url);
+    it = cache.entries.Put(
+        url, resources ? ToUrlCosmeticResources(*resources) : nullptr);
+  }
+
+  std::move(callback).Run(it->second.Clone());
 }
 
 }  // namespace cosmetic_filters
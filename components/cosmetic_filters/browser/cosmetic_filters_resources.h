@@ -7,6 +7,7 @@
 #define BRAVE_COMPONENTS_COSMETIC_FILTERS_BROWSER_COSMETIC_FILTERS_RESOURCES_H_
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -35,9 +36,10 @@ class CosmeticFiltersResources final
       brave_shields::AdBlockService* ad_block_service);
   ~CosmeticFiltersResources() override;
 
-  // Sends back to renderer a response about rules that has to be applied
-  // for the specified selectors.
-  void HiddenClassIdSelectors(const std::string& input,
+  // Sends back to renderer the hide selectors for the specified classes and
+  // ids which have not been sent since the last UrlCosmeticResources call.
+  void HiddenClassIdSelectors(const std::vector<std::string>& classes,
+                              const std::vector<std::string>& ids,
                               const std::vector<std::string>& exceptions,
                               HiddenClassIdSelectorsCallback callback) override;
 
@@ -49,6 +51,9 @@ class CosmeticFiltersResources final
 
  private:
   brave_shields::AdBlockService* ad_block_service_;  // Not owned
+
+  // Hide selectors already sent to the renderer for the current page.
+  std::set<std::string> sent_selectors_;
 };
 
 }  // namespace cosmetic_filters
@@ -14,6 +14,7 @@
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/trace_event/trace_event.h"
+#include "base/values.h"
 #include "brave/components/content_settings/renderer/brave_content_settings_agent_impl.h"
 #include "brave/components/cosmetic_filters/resources/grit/cosmetic_filters_generated_map.h"
 #include "components/content_settings/renderer/content_settings_agent_impl.h"
@@ -22,6 +23,7 @@
 #include "gin/function_template.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "third_party/blink/public/common/browser_interface_broker_proxy.h"
+#include "third_party/blink/public/platform/task_type.h"
 #include "third_party/blink/public/web/blink.h"
 #include "third_party/blink/public/web/web_document.h"
 #include "third_party/blink/public/web/web_local_frame.h"
@@ -35,6 +37,11 @@ static base::NoDestructor<std::vector<std::string>> g_vetted_search_engines(
     {"duckduckgo", "qwant", "bing", "startpage", "google", "yandex", "ecosia",
      "brave"});
 
+// Classes and ids reported by content_cosmetic.ts within this window, i.e. a
+// single animation frame, are sent to the browser process together.
+constexpr base::TimeDelta kHiddenClassIdSelectorsBatchDelay =
+    base::Milliseconds(16);
+
 // Entry point to content_cosmetic.ts script.
 const char kObservingScriptletEntryPoint[] =
     "window.content_cosmetic.tryScheduleQueuePump()";
@@ -199,18 +206,53 @@ CosmeticFiltersJSHandler::CosmeticFiltersJSHandler(
     : render_frame_(render_frame),
       isolated_world_id_(isolated_world_id),
       enabled_1st_party_cf_(false) {
+  hidden_class_id_selectors_timer_.SetTaskRunner(
+      render_frame_->GetTaskRunner(blink::TaskType::kInternalDefault));
   EnsureConnected();
 }
 
 CosmeticFiltersJSHandler::~CosmeticFiltersJSHandler() = default;
 
 void CosmeticFiltersJSHandler::HiddenClassIdSelectors(
-    const std::string& input) {
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids) {
+  for (const auto& class_name : classes) {
+    if (seen_classes_.insert(class_name).second)
+      pending_classes_.push_back(class_name);
+  }
+
+  for (const auto& id : ids) {
+    if (seen_ids_.insert(id).second)
+      pending_ids_.push_back(id);
+  }
+
+  if (pending_classes_.empty() && pending_ids_.empty())
+    return;
+
+  if (hidden_class_id_selectors_timer_.IsRunning())
+    return;
+
+  hidden_class_id_selectors_timer_.Start(
+      FROM_HERE, kHiddenClassIdSelectorsBatchDelay,
+      base::BindOnce(&CosmeticFiltersJSHandler::SendHiddenClassIdSelectors,
+                     base::Unretained(this)));
+}
+
+void CosmeticFiltersJSHandler::SendHiddenClassIdSelectors() {
+  std::vector<std::string> classes;
+  std::vector<std::string> ids;
+  classes.swap(pending_classes_);
+  ids.swap(pending_ids_);
+
   if (!EnsureConnected())
     return;
 
+  TRACE_COUNTER1("brave.adblock",
+                 "CosmeticFilters.HiddenClassIdSelectorsRoundTrips",
+                 ++hidden_class_id_selectors_round_trips_);
+
   cosmetic_filters_resources_->HiddenClassIdSelectors(
-      input, exceptions_,
+      classes, ids, exceptions_,
       base::BindOnce(&CosmeticFiltersJSHandler::OnHiddenClassIdSelectors,
                      base::Unretained(this)));
 }
@@ -304,7 +346,14 @@ void CosmeticFiltersJSHandler::OnRemoteDisconnect() {
 bool CosmeticFiltersJSHandler::ProcessURL(
     const GURL& url,
     absl::optional<base::OnceClosure> callback) {
-  resources_dict_.reset();
+  resources_.reset();
+  seen_classes_.clear();
+  seen_ids_.clear();
+  pending_classes_.clear();
+  pending_ids_.clear();
+  hidden_class_id_selectors_timer_.Stop();
+  hidden_class_id_selectors_round_trips_ = 0;
+  injected_selectors_count_ = 0;
   url_ = url;
   enabled_1st_party_cf_ = false;
 
@@ -336,10 +385,8 @@ bool CosmeticFiltersJSHandler::ProcessURL(
                  url_.spec());
     SCOPED_UMA_HISTOGRAM_TIMER_MICROS(
         "Brave.CosmeticFilters.UrlCosmeticResourcesSync");
-    base::Value result;
-    cosmetic_filters_resources_->UrlCosmeticResources(url_.spec(), &result);
-    resources_dict_ = base::DictionaryValue::From(
-        base::Value::ToUniquePtrValue(std::move(result)));
+    cosmetic_filters_resources_->UrlCosmeticResources(url_.spec(),
+                                                      &resources_);
   }
 
   return true;
@@ -347,28 +394,22 @@ bool CosmeticFiltersJSHandler::ProcessURL(
 
 void CosmeticFiltersJSHandler::OnUrlCosmeticResources(
     base::OnceClosure callback,
-    base::Value result) {
+    mojom::UrlCosmeticResourcesPtr resources) {
   if (!EnsureConnected())
     return;
 
-  resources_dict_ = base::DictionaryValue::From(
-      base::Value::ToUniquePtrValue(std::move(result)));
+  resources_ = std::move(resources);
   std::move(callback).Run();
 }
 
 void CosmeticFiltersJSHandler::ApplyRules() {
   blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
-  if (!resources_dict_ || web_frame->IsProvisional())
+  if (!resources_ || web_frame->IsProvisional())
     return;
 
-  std::string scriptlet_script;
-  base::Value* injected_script = resources_dict_->FindPath("injected_script");
-  if (injected_script &&
-      base::JSONWriter::Write(*injected_script, &scriptlet_script)) {
-    scriptlet_script =
-        base::StringPrintf(kScriptletInitScript, scriptlet_script.c_str());
-  }
-  if (!scriptlet_script.empty()) {
+  if (!resources_->injected_script.empty()) {
+    std::string scriptlet_script = base::StringPrintf(
+        kScriptletInitScript, resources_->injected_script.c_str());
     web_frame->ExecuteScriptInIsolatedWorld(
         isolated_world_id_, blink::WebString::FromUTF8(scriptlet_script),
         blink::BackForwardCacheAware::kAllow);
@@ -378,11 +419,9 @@ void CosmeticFiltersJSHandler::ApplyRules() {
     return;
 
   // Working on css rules, we do that on a main frame only
-  bool generichide = false;
-  resources_dict_->GetBoolean("generichide", &generichide);
   std::string cosmetic_filtering_init_script = base::StringPrintf(
       kCosmeticFilteringInitScript, enabled_1st_party_cf_ ? "true" : "false",
-      generichide ? "true" : "false");
+      resources_->generichide ? "true" : "false");
   std::string pre_init_script = base::StringPrintf(
       kPreInitScript, cosmetic_filtering_init_script.c_str());
 
@@ -391,107 +430,79 @@ void CosmeticFiltersJSHandler::ApplyRules() {
       blink::BackForwardCacheAware::kAllow);
   ExecuteObservingBundleEntryPoint();
 
-  CSSRulesRoutine(resources_dict_.get());
+  CSSRulesRoutine(*resources_);
 }
 
 void CosmeticFiltersJSHandler::CSSRulesRoutine(
-    base::DictionaryValue* resources_dict) {
+    const mojom::UrlCosmeticResources& resources) {
   // Otherwise, if its a vetted engine AND we're not in aggressive
   // mode, also don't do cosmetic filtering.
   if (!enabled_1st_party_cf_ && IsVettedSearchEngine(url_))
     return;
 
   blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
-  base::ListValue* cf_exceptions_list;
-  if (resources_dict->GetList("exceptions", &cf_exceptions_list)) {
-    for (size_t i = 0; i < cf_exceptions_list->GetList().size(); i++) {
-      exceptions_.push_back(cf_exceptions_list->GetList()[i].GetString());
-    }
-  }
-  base::ListValue* hide_selectors_list;
-  if (!resources_dict->GetList("hide_selectors", &hide_selectors_list)) {
-    hide_selectors_list = nullptr;
-  }
-  base::ListValue* force_hide_selectors_list;
-  if (!resources_dict->GetList("force_hide_selectors",
-                               &force_hide_selectors_list)) {
-    force_hide_selectors_list = nullptr;
-  }
+  exceptions_.insert(exceptions_.end(), resources.exceptions.cbegin(),
+                     resources.exceptions.cend());
 
-  if (hide_selectors_list && hide_selectors_list->GetList().size() != 0) {
-    std::string json_selectors;
-    if (!base::JSONWriter::Write(*hide_selectors_list, &json_selectors) ||
-        json_selectors.empty()) {
-      json_selectors = "[]";
-    }
+  // Selectors are already JSON encoded by the browser process
+  if (!resources.hide_selectors.empty()) {
     // Building a script for stylesheet modifications
-    std::string new_selectors_script =
-        base::StringPrintf(kHideSelectorsInjectScript, json_selectors.c_str());
+    std::string new_selectors_script = base::StringPrintf(
+        kHideSelectorsInjectScript, resources.hide_selectors.c_str());
     web_frame->ExecuteScriptInIsolatedWorld(
         isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script),
         blink::BackForwardCacheAware::kAllow);
   }
 
-  if (force_hide_selectors_list &&
-      force_hide_selectors_list->GetList().size() != 0) {
-    std::string json_selectors;
-    if (!base::JSONWriter::Write(*force_hide_selectors_list, &json_selectors) ||
-        json_selectors.empty()) {
-      json_selectors = "[]";
-    }
+  if (!resources.force_hide_selectors.empty()) {
     // Building a script for stylesheet modifications
-    std::string new_selectors_script = base::StringPrintf(
-        kForceHideSelectorsInjectScript, json_selectors.c_str());
+    std::string new_selectors_script =
+        base::StringPrintf(kForceHideSelectorsInjectScript,
+                           resources.force_hide_selectors.c_str());
     web_frame->ExecuteScriptInIsolatedWorld(
         isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script),
         blink::BackForwardCacheAware::kAllow);
   }
 
-  base::DictionaryValue* style_selectors_dictionary = nullptr;
-  if (resources_dict->GetDictionary("style_selectors",
-                                    &style_selectors_dictionary)) {
-    std::string json_selectors;
-    if (!base::JSONWriter::Write(*style_selectors_dictionary,
-                                 &json_selectors) ||
-        json_selectors.empty()) {
-      json_selectors = "[]";
-    }
-    std::string new_selectors_script =
-        base::StringPrintf(kStyleSelectorsInjectScript, json_selectors.c_str());
-    if (!json_selectors.empty()) {
-      web_frame->ExecuteScriptInIsolatedWorld(
-          isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script),
-          blink::BackForwardCacheAware::kAllow);
-    }
+  if (!resources.style_selectors.empty()) {
+    std::string new_selectors_script = base::StringPrintf(
+        kStyleSelectorsInjectScript, resources.style_selectors.c_str());
+    web_frame->ExecuteScriptInIsolatedWorld(
+        isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script),
+        blink::BackForwardCacheAware::kAllow);
   }
 
   if (!enabled_1st_party_cf_)
     ExecuteObservingBundleEntryPoint();
 }
 
-void CosmeticFiltersJSHandler::OnHiddenClassIdSelectors(base::Value result) {
+void CosmeticFiltersJSHandler::OnHiddenClassIdSelectors(
+    const std::vector<std::string>& selectors) {
   // If its a vetted engine AND we're not in aggressive
   // mode, don't do cosmetic filtering.
   if (!enabled_1st_party_cf_ && IsVettedSearchEngine(url_))
     return;
 
-  // We expect a List value from adblock service. That is
-  // an extra check to be sure that adblock file exist and gives us
-  // rules that we expect
-  base::ListValue* selectors_list;
-  if (!result.GetAsList(&selectors_list))
-    return;
+  // The browser process only sends selectors which are new to the page
+  if (!selectors.empty()) {
+    injected_selectors_count_ += selectors.size();
+    TRACE_COUNTER1("brave.adblock", "CosmeticFilters.InjectedSelectors",
+                   injected_selectors_count_);
 
-  blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
-  std::string json_selectors;
-  if (!base::JSONWriter::Write(*selectors_list, &json_selectors) ||
-      json_selectors.empty()) {
-    json_selectors = "[]";
-  }
-  // Building a script for stylesheet modifications
-  std::string new_selectors_script =
-      base::StringPrintf(kHideSelectorsInjectScript, json_selectors.c_str());
-  if (selectors_list->GetList().size() != 0) {
+    base::ListValue selectors_list;
+    for (const auto& selector : selectors) {
+      selectors_list.Append(selector);
+    }
+
+    blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
+    std::string json_selectors;
+    if (!base::JSONWriter::Write(selectors_list, &json_selectors) ||
+        json_selectors.empty()) {
+      json_selectors = "[]";
+    }
+    // Building a script for stylesheet modifications
+    std::string new_selectors_script =
+        base::StringPrintf(kHideSelectorsInjectScript, json_selectors.c_str());
     web_frame->ExecuteScriptInIsolatedWorld(
         isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script),
         blink::BackForwardCacheAware::kAllow);
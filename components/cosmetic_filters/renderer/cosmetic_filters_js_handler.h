@@ -7,10 +7,12 @@
 #define BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_COSMETIC_FILTERS_JS_HANDLER_H_
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
 #include "brave/components/cosmetic_filters/common/cosmetic_filters.mojom.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
@@ -58,13 +60,16 @@ class CosmeticFiltersJSHandler {
 
   void CreateWorkerObject(v8::Isolate* isolate, v8::Local<v8::Context> context);
 
-  // A function to be called from JS
-  void HiddenClassIdSelectors(const std::string& input);
+  // A function to be called from JS. Queues the classes and ids not seen yet
+  // on the current page, which are sent to the browser in a single batch.
+  void HiddenClassIdSelectors(const std::vector<std::string>& classes,
+                              const std::vector<std::string>& ids);
+  void SendHiddenClassIdSelectors();
 
   void OnUrlCosmeticResources(base::OnceClosure callback,
-                              base::Value result);
-  void CSSRulesRoutine(base::DictionaryValue* resources_dict);
-  void OnHiddenClassIdSelectors(base::Value result);
+                              mojom::UrlCosmeticResourcesPtr resources);
+  void CSSRulesRoutine(const mojom::UrlCosmeticResources& resources);
+  void OnHiddenClassIdSelectors(const std::vector<std::string>& selectors);
   bool OnIsFirstParty(const std::string& url_string);
 
   content::RenderFrame* render_frame_;
@@ -74,7 +79,18 @@ class CosmeticFiltersJSHandler {
   bool enabled_1st_party_cf_;
   std::vector<std::string> exceptions_;
   GURL url_;
-  std::unique_ptr<base::DictionaryValue> resources_dict_;
+  mojom::UrlCosmeticResourcesPtr resources_;
+
+  // Classes and ids already queued for the current page.
+  std::set<std::string> seen_classes_;
+  std::set<std::string> seen_ids_;
+  std::vector<std::string> pending_classes_;
+  std::vector<std::string> pending_ids_;
+  base::OneShotTimer hidden_class_id_selectors_timer_;
+
+  // Used for tracing only.
+  int hidden_class_id_selectors_round_trips_ = 0;
+  int injected_selectors_count_ = 0;
 
   // True if the content_cosmetic.bundle.js has injected in the current frame.
   bool bundle_injected_ = false;
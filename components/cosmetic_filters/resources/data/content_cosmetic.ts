@@ -94,12 +94,9 @@ const fetchNewClassIdRules = () => {
     (!notYetQueriedIds || notYetQueriedIds.length === 0)) {
     return
   }
-  // Callback to c++ renderer process
+  // Callback to c++ renderer process, which batches the classes and ids
   // @ts-expect-error
-  cf_worker.hiddenClassIdSelectors(
-      JSON.stringify({
-        classes: notYetQueriedClasses, ids: notYetQueriedIds
-      }))
+  cf_worker.hiddenClassIdSelectors(notYetQueriedClasses, notYetQueriedIds)
   notYetQueriedClasses = []
   notYetQueriedIds = []
 }
@@ -17,7 +17,6 @@
 #include "base/task/thread_pool.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
 #include "brave/components/brave_component_updater/browser/local_data_files_service.h"
-#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 
 using brave_component_updater::LocalDataFilesObserver;
 using brave_component_updater::LocalDataFilesService;
@@ -54,27 +53,17 @@ void DebounceComponentInstaller::OnDATFileDataReady(
     VLOG(1) << "Failed to parse debounce configuration";
     return;
   }
+  // Drop the index before the rules it points into.
+  rule_index_ = DebounceRuleIndex();
   rules_.clear();
-  host_cache_.clear();
-  std::vector<std::string> hosts;
   base::JSONValueConverter<DebounceRule> converter;
   for (base::Value& it : root->GetList()) {
     std::unique_ptr<DebounceRule> rule = std::make_unique<DebounceRule>();
     if (!converter.Convert(it, rule.get()))
       continue;
-    for (const URLPattern& pattern : rule->include_pattern_set()) {
-      if (!pattern.host().empty()) {
-        std::string etldp1 =
-            net::registry_controlled_domains::GetDomainAndRegistry(
-                pattern.host(),
-                net::registry_controlled_domains::PrivateRegistryFilter::
-                    INCLUDE_PRIVATE_REGISTRIES);
-        hosts.push_back(std::move(etldp1));
-      }
-    }
     rules_.push_back(std::move(rule));
   }
-  host_cache_ = std::move(hosts);
+  rule_index_ = DebounceRuleIndex(rules_);
   for (Observer& observer : observers_)
     observer.OnRulesReady(this);
 }
@@ -6,7 +6,9 @@
 #include "brave/components/debounce/browser/debounce_rule.h"
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "base/base64url.h"
 #include "net/base/url_util.h"
@@ -71,7 +73,18 @@ void DebounceRule::RegisterJSONConverter(
   converter->RegisterStringField(kParam, &DebounceRule::param_);
 }
 
-bool DebounceRule::Apply(const GURL& original_url, GURL* final_url) const {
+// static
+DebounceRule::QueryParams DebounceRule::ParseQueryParams(const GURL& url) {
+  std::vector<std::pair<std::string, std::string>> params;
+  for (net::QueryIterator it(url); !it.IsAtEnd(); it.Advance())
+    params.emplace_back(std::string(it.GetKey()), it.GetUnescapedValue());
+  // flat_map keeps the first of several equal keys.
+  return QueryParams(std::move(params));
+}
+
+bool DebounceRule::Apply(const GURL& original_url,
+                         const QueryParams& query_params,
+                         GURL* final_url) const {
   // Unknown actions always return false, to allow for future updates to the
   // rules file which may be pushed to users before a new version of the code
   // that parses it.
@@ -86,9 +99,10 @@ bool DebounceRule::Apply(const GURL& original_url, GURL* final_url) const {
   if (!include_pattern_set_.MatchesURL(original_url))
     return false;
 
-  std::string unescaped_value;
-  if (!net::GetValueForKeyInQuery(original_url, param_, &unescaped_value))
+  auto param = query_params.find(param_);
+  if (param == query_params.end())
     return false;
+  std::string unescaped_value = param->second;
   if ((action_ == kDebounceBase64DecodeAndRedirectToParam) &&
       (!base::Base64UrlDecode(unescaped_value,
                               base::Base64UrlDecodePolicy::IGNORE_PADDING,
@@ -8,6 +8,7 @@
 
 #include <string>
 
+#include "base/containers/flat_map.h"
 #include "base/json/json_value_converter.h"
 #include "base/values.h"
 #include "extensions/common/url_pattern_set.h"
@@ -24,6 +25,11 @@ enum DebounceAction {
 
 class DebounceRule {
  public:
+  // Query parameters keyed by their (still escaped) name, with unescaped
+  // values. Only the first value of a repeated parameter is kept, like
+  // net::GetValueForKeyInQuery.
+  using QueryParams = base::flat_map<std::string, std::string>;
+
   DebounceRule();
   ~DebounceRule();
 
@@ -36,7 +42,13 @@ class DebounceRule {
   static bool GetURLPatternSetFromValue(const base::Value* value,
                                         extensions::URLPatternSet* result);
 
-  bool Apply(const GURL& original_url, GURL* final_url) const;
+  static QueryParams ParseQueryParams(const GURL& url);
+
+  // |query_params| must be ParseQueryParams(original_url), so that applying
+  // several rules to one URL only parses its query string once.
+  bool Apply(const GURL& original_url,
+             const QueryParams& query_params,
+             GURL* final_url) const;
   const extensions::URLPatternSet& include_pattern_set() const {
     return include_pattern_set_;
   }
@@ -0,0 +1,121 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/debounce/browser/debounce_rule_index.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#include "brave/components/debounce/browser/debounce_rule.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "url/gurl.h"
+
+namespace debounce {
+
+namespace {
+
+std::string GetETLDP1(const GURL& url) {
+  return net::registry_controlled_domains::GetDomainAndRegistry(
+      url, net::registry_controlled_domains::PrivateRegistryFilter::
+               INCLUDE_PRIVATE_REGISTRIES);
+}
+
+}  // namespace
+
+DebounceRuleIndex::DebounceRuleIndex() = default;
+
+DebounceRuleIndex::DebounceRuleIndex(
+    const std::vector<std::unique_ptr<DebounceRule>>& rules) {
+  std::vector<std::pair<std::string, std::vector<size_t>>> rules_by_etldp1;
+  base::flat_map<std::string, size_t> etldp1_indexes;
+  for (size_t i = 0; i < rules.size(); ++i) {
+    rules_.push_back(rules[i].get());
+    bool is_global = false;
+    for (const URLPattern& pattern : rules[i]->include_pattern_set()) {
+      if (pattern.host().empty()) {
+        is_global = true;
+        continue;
+      }
+      std::string etldp1 =
+          net::registry_controlled_domains::GetDomainAndRegistry(
+              pattern.host(), net::registry_controlled_domains::
+                                  PrivateRegistryFilter::
+                                      INCLUDE_PRIVATE_REGISTRIES);
+      // A host without an eTLD+1 (an IP address, or a public suffix with
+      // |match_subdomains|) can match URLs on other sites too.
+      if (etldp1.empty())
+        is_global = true;
+      auto inserted = etldp1_indexes.emplace(etldp1, rules_by_etldp1.size());
+      if (inserted.second)
+        rules_by_etldp1.emplace_back(std::move(etldp1), std::vector<size_t>());
+      std::vector<size_t>& etldp1_rules =
+          rules_by_etldp1[inserted.first->second].second;
+      if (etldp1_rules.empty() || etldp1_rules.back() != i)
+        etldp1_rules.push_back(i);
+    }
+    if (is_global)
+      global_rules_.push_back(i);
+  }
+
+  for (auto& etldp1_rules : rules_by_etldp1) {
+    std::vector<size_t> merged;
+    std::set_union(etldp1_rules.second.begin(), etldp1_rules.second.end(),
+                   global_rules_.begin(), global_rules_.end(),
+                   std::back_inserter(merged));
+    etldp1_rules.second = std::move(merged);
+  }
+  rules_by_etldp1_ = base::flat_map<std::string, std::vector<size_t>>(
+      std::move(rules_by_etldp1));
+}
+
+DebounceRuleIndex::DebounceRuleIndex(DebounceRuleIndex&&) = default;
+DebounceRuleIndex& DebounceRuleIndex::operator=(DebounceRuleIndex&&) = default;
+DebounceRuleIndex::~DebounceRuleIndex() = default;
+
+const std::vector<size_t>& DebounceRuleIndex::GetRulesForETLDP1(
+    const std::string& etldp1) const {
+  auto it = rules_by_etldp1_.find(etldp1);
+  return it == rules_by_etldp1_.end() ? global_rules_ : it->second;
+}
+
+bool DebounceRuleIndex::Apply(const GURL& original_url,
+                              GURL* final_url) const {
+  // Only URLs on a site named by some include pattern are debounced at all.
+  auto it = rules_by_etldp1_.find(GetETLDP1(original_url));
+  if (it == rules_by_etldp1_.end())
+    return false;
+
+  bool changed = false;
+  GURL current_url = original_url;
+  DebounceRule::QueryParams query_params =
+      DebounceRule::ParseQueryParams(current_url);
+  const std::vector<size_t>* candidates = &it->second;
+
+  // Debounce rules are applied in order. If one rule applies, the URL is
+  // changed to the debounced URL and we continue to apply the rest of the
+  // rules to the new URL. Previously checked rules are not reapplied; i.e. we
+  // never restart the loop. The debounced URL may be on another site, so the
+  // remaining candidates are taken from that site's rules.
+  size_t next_candidate = 0;
+  while (next_candidate < candidates->size()) {
+    const size_t rule_index = (*candidates)[next_candidate++];
+    if (!rules_[rule_index]->Apply(current_url, query_params, final_url) ||
+        current_url == *final_url) {
+      continue;
+    }
+    changed = true;
+    current_url = *final_url;
+    query_params = DebounceRule::ParseQueryParams(current_url);
+    candidates = &GetRulesForETLDP1(GetETLDP1(current_url));
+    next_candidate = std::upper_bound(candidates->begin(), candidates->end(),
+                                      rule_index) -
+                     candidates->begin();
+  }
+  return changed;
+}
+
+}  // namespace debounce
@@ -0,0 +1,56 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_DEBOUNCE_BROWSER_DEBOUNCE_RULE_INDEX_H_
+#define BRAVE_COMPONENTS_DEBOUNCE_BROWSER_DEBOUNCE_RULE_INDEX_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+
+class GURL;
+
+namespace debounce {
+
+class DebounceRule;
+
+// Maps the eTLD+1 of a URL to the ordered subset of debounce rules whose
+// include patterns can match it, so a URL is only checked against the rules
+// written for its site. The rules themselves are owned by the caller and must
+// outlive the index.
+class DebounceRuleIndex {
+ public:
+  DebounceRuleIndex();
+  explicit DebounceRuleIndex(
+      const std::vector<std::unique_ptr<DebounceRule>>& rules);
+  DebounceRuleIndex(DebounceRuleIndex&&);
+  DebounceRuleIndex& operator=(DebounceRuleIndex&&);
+  ~DebounceRuleIndex();
+
+  // Applies the indexed rules to |original_url| in order, the same way
+  // DebounceService applied every rule before the index existed. Returns true
+  // and sets |final_url| if any rule changed the URL.
+  bool Apply(const GURL& original_url, GURL* final_url) const;
+
+ private:
+  const std::vector<size_t>& GetRulesForETLDP1(
+      const std::string& etldp1) const;
+
+  std::vector<const DebounceRule*> rules_;
+  // Sorted indexes into |rules_| for each eTLD+1 named by an include pattern.
+  // Every list also contains |global_rules_|.
+  base::flat_map<std::string, std::vector<size_t>> rules_by_etldp1_;
+  // Rules with a pattern that isn't tied to a single eTLD+1, e.g. one that
+  // matches all hosts or every subdomain of a public suffix.
+  std::vector<size_t> global_rules_;
+};
+
+}  // namespace debounce
+
+#endif  // BRAVE_COMPONENTS_DEBOUNCE_BROWSER_DEBOUNCE_RULE_INDEX_H_
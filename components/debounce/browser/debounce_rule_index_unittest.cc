@@ -0,0 +1,290 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/contains.h"
+#include "base/containers/flat_set.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_value_converter.h"
+#include "base/logging.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/components/debounce/browser/debounce_rule.h"
+#include "brave/components/debounce/browser/debounce_rule_index.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "net/base/url_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace debounce {
+
+namespace {
+
+using Rules = std::vector<std::unique_ptr<DebounceRule>>;
+
+Rules ParseRules(const std::string& json) {
+  Rules rules;
+  absl::optional<base::Value> root = base::JSONReader::Read(json);
+  EXPECT_TRUE(root);
+  base::JSONValueConverter<DebounceRule> converter;
+  for (const base::Value& it : root->GetList()) {
+    auto rule = std::make_unique<DebounceRule>();
+    if (converter.Convert(it, rule.get()))
+      rules.push_back(std::move(rule));
+  }
+  return rules;
+}
+
+std::string GetETLDP1(base::StringPiece host) {
+  return net::registry_controlled_domains::GetDomainAndRegistry(
+      host, net::registry_controlled_domains::PrivateRegistryFilter::
+                INCLUDE_PRIVATE_REGISTRIES);
+}
+
+// Applies every rule in order, the way DebounceService did before the index.
+class UnindexedRules {
+ public:
+  explicit UnindexedRules(const Rules& rules) : rules_(rules) {
+    std::vector<std::string> hosts;
+    for (const auto& rule : rules) {
+      for (const URLPattern& pattern : rule->include_pattern_set()) {
+        if (!pattern.host().empty())
+          hosts.push_back(GetETLDP1(pattern.host()));
+      }
+    }
+    host_cache_ = std::move(hosts);
+  }
+
+  bool Apply(const GURL& original_url, GURL* final_url) const {
+    if (!base::Contains(host_cache_, GetETLDP1(original_url.host_piece())))
+      return false;
+    bool changed = false;
+    GURL current_url = original_url;
+    for (const auto& rule : rules_) {
+      if (rule->Apply(current_url, DebounceRule::ParseQueryParams(current_url),
+                      final_url) &&
+          current_url != *final_url) {
+        changed = true;
+        current_url = *final_url;
+      }
+    }
+    return changed;
+  }
+
+ private:
+  const Rules& rules_;
+  base::flat_set<std::string> host_cache_;
+};
+
+std::string Redirect(const std::string& from,
+                     const std::string& param,
+                     const std::string& to) {
+  return net::AppendQueryParameter(GURL(from), param, to).spec();
+}
+
+// The production rule file isn't part of the tree, so this is a synthetic
+// list of the same shape: a few hundred sites, most with one or two rules
+// for their own (sub)domains.
+constexpr int kSyntheticRuleSites = 400;
+
+Rules BuildSyntheticRules() {
+  std::vector<std::string> json_rules;
+  for (int i = 0; i < kSyntheticRuleSites; ++i) {
+    json_rules.push_back(base::StringPrintf(
+        R"({"include": ["*://*.tracker%d.com/*"],)"
+        R"("exclude": ["*://*.tracker%d.com/static/*"],)"
+        R"("action": "redirect", "param": "url"})",
+        i, i));
+    if (i % 4 == 0) {
+      json_rules.push_back(base::StringPrintf(
+          R"({"include": ["*://click.tracker%d.com/*"],)"
+          R"("action": "base64,redirect", "param": "dest"})",
+          i));
+    }
+  }
+  return ParseRules("[" + base::JoinString(json_rules, ",") + "]");
+}
+
+// A corpus dominated by URLs on sites without rules, like a top sites list.
+std::vector<GURL> BuildSyntheticCorpus() {
+  const int kCorpusSites = 2000;
+
+  std::vector<GURL> corpus;
+  for (int i = 0; i < kCorpusSites; ++i) {
+    corpus.emplace_back(base::StringPrintf(
+        "https://www.site%d.com/article?id=%d&utm_source=feed&ref=home", i,
+        i));
+    if (i % 10 == 0) {
+      corpus.emplace_back(Redirect(
+          base::StringPrintf("https://www.tracker%d.com/c?id=%d",
+                             i % kSyntheticRuleSites, i),
+          "url", base::StringPrintf("https://www.site%d.com/", i)));
+    }
+  }
+  return corpus;
+}
+
+}  // namespace
+
+TEST(DebounceRuleIndexTest, Apply) {
+  const Rules rules = ParseRules(R"([
+    {"include": ["*://*.b.com/*"], "exclude": [],
+     "action": "redirect", "param": "u"},
+    {"include": ["*://a.com/*", "*://tracker.a.co.uk/*"],
+     "exclude": ["*://a.com/skip*"], "action": "redirect", "param": "url"},
+    {"include": ["*://*.b.com/*"], "exclude": [],
+     "action": "redirect", "param": "url"},
+    {"include": ["*://base64.c.com/*"], "exclude": [],
+     "action": "base64,redirect", "param": "url"},
+    {"include": ["*://*.c.com/*"], "exclude": [],
+     "action": "unknown", "param": "url"}
+  ])");
+  ASSERT_EQ(4u, rules.size());
+  DebounceRuleIndex index(rules);
+  GURL final_url;
+
+  EXPECT_TRUE(index.Apply(
+      GURL(Redirect("http://a.com/", "url", "https://d.com/")), &final_url));
+  EXPECT_EQ(GURL("https://d.com/"), final_url);
+
+  EXPECT_TRUE(index.Apply(
+      GURL(Redirect("https://tracker.a.co.uk/", "url", "https://d.com/")),
+      &final_url));
+  EXPECT_EQ(GURL("https://d.com/"), final_url);
+
+  EXPECT_TRUE(index.Apply(
+      GURL("https://base64.c.com/?url=aHR0cHM6Ly9kLmNvbS8"), &final_url));
+  EXPECT_EQ(GURL("https://d.com/"), final_url);
+
+  // Excluded, on a site without rules, or without the parameter.
+  EXPECT_FALSE(index.Apply(
+      GURL(Redirect("http://a.com/skip", "url", "https://d.com/")),
+      &final_url));
+  EXPECT_FALSE(index.Apply(
+      GURL(Redirect("http://d.com/", "url", "https://e.com/")), &final_url));
+  EXPECT_FALSE(index.Apply(
+      GURL(Redirect("http://other.a.co.uk/", "url", "https://d.com/")),
+      &final_url));
+  EXPECT_FALSE(index.Apply(GURL("http://a.com/?other=https://d.com/"),
+                           &final_url));
+
+  // Only the first value of a repeated parameter is used.
+  EXPECT_TRUE(index.Apply(
+      GURL("http://a.com/?url=https%3A%2F%2Fd.com%2F&url=https://e.com/"),
+      &final_url));
+  EXPECT_EQ(GURL("https://d.com/"), final_url);
+}
+
+TEST(DebounceRuleIndexTest, ChainsAcrossSitesInRuleOrder) {
+  const Rules rules = ParseRules(R"([
+    {"include": ["*://*.b.com/*"], "action": "redirect", "param": "u"},
+    {"include": ["*://a.com/*"], "action": "redirect", "param": "url"},
+    {"include": ["*://*.b.com/*"], "action": "redirect", "param": "url"}
+  ])");
+  DebounceRuleIndex index(rules);
+
+  // a.com redirects to b.com, which is then only checked against the b.com
+  // rule that comes after the a.com one.
+  const std::string b_url =
+      "https://b.com/?url=https://c.com/&u=https://d.com/";
+  GURL final_url;
+  EXPECT_TRUE(index.Apply(GURL(Redirect("https://a.com/", "url", b_url)),
+                          &final_url));
+  EXPECT_EQ(GURL("https://c.com/"), final_url);
+
+  // Starting on b.com the first rule wins, and the URL leaves b.com.
+  EXPECT_TRUE(index.Apply(GURL(b_url), &final_url));
+  EXPECT_EQ(GURL("https://d.com/"), final_url);
+}
+
+TEST(DebounceRuleIndexTest, GlobalRules) {
+  const Rules rules = ParseRules(R"([
+    {"include": ["*://a.com/*"], "action": "redirect", "param": "url"},
+    {"include": ["*://*/*"], "action": "redirect", "param": "next"},
+    {"include": ["*://127.0.0.1/*"], "action": "redirect", "param": "ip"}
+  ])");
+  DebounceRuleIndex index(rules);
+  UnindexedRules unindexed(rules);
+
+  const std::vector<std::string> urls = {
+      // Rules that match all hosts apply once a site has rules of its own...
+      "https://a.com/?next=https://d.com/",
+      "https://a.com/?url=https://b.com/%3Fnext%3Dhttps://d.com/",
+      // ...but don't make every site eligible for debouncing.
+      "https://b.com/?next=https://d.com/",
+      "https://127.0.0.1/?ip=https://d.com/",
+      "https://127.0.0.1/?next=https://d.com/",
+      "https://10.0.0.1/?next=https://d.com/",
+  };
+  for (const auto& url : urls) {
+    GURL indexed_url;
+    GURL unindexed_url;
+    const bool indexed = index.Apply(GURL(url), &indexed_url);
+    EXPECT_EQ(unindexed.Apply(GURL(url), &unindexed_url), indexed) << url;
+    if (indexed)
+      EXPECT_EQ(unindexed_url, indexed_url) << url;
+  }
+  GURL final_url;
+  EXPECT_TRUE(index.Apply(
+      GURL("https://a.com/?url=https://b.com/%3Fnext%3Dhttps://d.com/"),
+      &final_url));
+  EXPECT_EQ(GURL("https://d.com/"), final_url);
+  EXPECT_FALSE(
+      index.Apply(GURL("https://b.com/?next=https://d.com/"), &final_url));
+}
+
+TEST(DebounceRuleIndexTest, MatchesEveryRuleOnSyntheticList) {
+  const Rules rules = BuildSyntheticRules();
+  DebounceRuleIndex index(rules);
+  UnindexedRules unindexed(rules);
+
+  for (const GURL& url : BuildSyntheticCorpus()) {
+    GURL indexed_url;
+    GURL unindexed_url;
+    const bool indexed = index.Apply(url, &indexed_url);
+    ASSERT_EQ(unindexed.Apply(url, &unindexed_url), indexed) << url;
+    if (indexed)
+      ASSERT_EQ(unindexed_url, indexed_url) << url;
+  }
+}
+
+// Compares checking every rule with the index for the synthetic list.
+// Disabled as it only logs timings, run it with
+// --gtest_also_run_disabled_tests.
+TEST(DebounceRuleIndexTest, DISABLED_LookupBenchmark) {
+  const int kIterations = 5;
+
+  const Rules rules = BuildSyntheticRules();
+  const std::vector<GURL> corpus = BuildSyntheticCorpus();
+  DebounceRuleIndex index(rules);
+  UnindexedRules unindexed(rules);
+
+  GURL final_url;
+  base::ElapsedTimer unindexed_timer;
+  for (int iteration = 0; iteration < kIterations; ++iteration) {
+    for (const GURL& url : corpus)
+      unindexed.Apply(url, &final_url);
+  }
+  const base::TimeDelta unindexed_time = unindexed_timer.Elapsed();
+
+  base::ElapsedTimer indexed_timer;
+  for (int iteration = 0; iteration < kIterations; ++iteration) {
+    for (const GURL& url : corpus)
+      index.Apply(url, &final_url);
+  }
+  const base::TimeDelta indexed_time = indexed_timer.Elapsed();
+
+  const size_t lookups = corpus.size() * kIterations;
+  LOG(INFO) << "Debounce latency over " << lookups << " URLs and "
+            << rules.size() << " rules: every rule "
+            << unindexed_time.InMicrosecondsF() / lookups << "us, "
+            << "indexed " << indexed_time.InMicrosecondsF() / lookups << "us";
+}
+
+}  // namespace debounce
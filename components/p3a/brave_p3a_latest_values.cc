@@ -0,0 +1,53 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_latest_values.h"
+
+#include <limits>
+
+#include "base/check.h"
+
+namespace brave {
+
+namespace {
+
+// Marks the metrics without a value recorded since the last drain.
+constexpr int64_t kNoValue = std::numeric_limits<int64_t>::min();
+
+}  // namespace
+
+BraveP3ALatestValues::BraveP3ALatestValues(size_t size) : values_(size) {
+  for (auto& value : values_) {
+    value.store(kNoValue);
+  }
+}
+
+BraveP3ALatestValues::~BraveP3ALatestValues() = default;
+
+bool BraveP3ALatestValues::Record(size_t index, int64_t value) {
+  DCHECK_LT(index, values_.size());
+  DCHECK_NE(kNoValue, value);
+
+  values_[index].store(value);
+
+  return !is_drain_scheduled_.exchange(true);
+}
+
+void BraveP3ALatestValues::Drain(const DrainCallback& callback) {
+  // Reset the flag first, so values recorded while draining schedule the
+  // next drain.
+  is_drain_scheduled_.store(false);
+
+  for (size_t i = 0; i < values_.size(); i++) {
+    const int64_t value = values_[i].exchange(kNoValue);
+    if (value == kNoValue) {
+      continue;
+    }
+
+    callback.Run(i, value);
+  }
+}
+
+}  // namespace brave
@@ -0,0 +1,47 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_P3A_BRAVE_P3A_LATEST_VALUES_H_
+#define BRAVE_COMPONENTS_P3A_BRAVE_P3A_LATEST_VALUES_H_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "base/callback.h"
+
+namespace brave {
+
+// Keeps the latest value recorded for each metric, identified by its index.
+// Values can be recorded on any thread without taking locks, and are drained
+// on a single sequence.
+class BraveP3ALatestValues {
+ public:
+  using DrainCallback =
+      base::RepeatingCallback<void(size_t index, int64_t value)>;
+
+  explicit BraveP3ALatestValues(size_t size);
+  ~BraveP3ALatestValues();
+
+  BraveP3ALatestValues(const BraveP3ALatestValues&) = delete;
+  BraveP3ALatestValues& operator=(const BraveP3ALatestValues&) = delete;
+
+  // Overwrites the value of the metric which is not drained yet, if any.
+  // Returns true for the first value recorded since the last drain, in which
+  // case the caller should schedule the next |Drain()|.
+  bool Record(size_t index, int64_t value);
+
+  // Runs |callback| for each metric recorded since the last drain. Values
+  // recorded while draining make |Record()| schedule another drain.
+  void Drain(const DrainCallback& callback);
+
+ private:
+  std::vector<std::atomic<int64_t>> values_;
+  std::atomic<bool> is_drain_scheduled_{false};
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMPONENTS_P3A_BRAVE_P3A_LATEST_VALUES_H_
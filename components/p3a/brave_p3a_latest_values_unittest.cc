@@ -0,0 +1,71 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_latest_values.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveP3ALatestValuesTest.*
+
+namespace brave {
+
+namespace {
+
+std::vector<std::pair<size_t, int64_t>> Drain(BraveP3ALatestValues* values) {
+  std::vector<std::pair<size_t, int64_t>> drained;
+  values->Drain(base::BindRepeating(
+      [](std::vector<std::pair<size_t, int64_t>>* drained, size_t index,
+         int64_t value) { drained->emplace_back(index, value); },
+      &drained));
+  return drained;
+}
+
+}  // namespace
+
+TEST(BraveP3ALatestValuesTest, KeepOnlyLatestValue) {
+  BraveP3ALatestValues values(3);
+
+  EXPECT_TRUE(values.Record(1, 10));
+  EXPECT_FALSE(values.Record(1, 20));
+  EXPECT_FALSE(values.Record(2, 5));
+  EXPECT_FALSE(values.Record(1, 30));
+
+  const std::vector<std::pair<size_t, int64_t>> expected = {{1, 30}, {2, 5}};
+  EXPECT_EQ(expected, Drain(&values));
+  EXPECT_TRUE(Drain(&values).empty());
+}
+
+TEST(BraveP3ALatestValuesTest, ScheduleDrainAfterDrain) {
+  BraveP3ALatestValues values(2);
+
+  EXPECT_TRUE(values.Record(0, 1));
+  Drain(&values);
+
+  EXPECT_TRUE(values.Record(0, 2));
+}
+
+TEST(BraveP3ALatestValuesTest, RecordDuringDrainSchedulesAnotherDrain) {
+  BraveP3ALatestValues values(2);
+  EXPECT_TRUE(values.Record(0, 1));
+
+  bool is_drain_scheduled = false;
+  values.Drain(base::BindRepeating(
+      [](BraveP3ALatestValues* values, bool* is_drain_scheduled, size_t index,
+         int64_t value) {
+        // Simulates a sample recorded on another thread while draining.
+        *is_drain_scheduled = values->Record(1, 7);
+      },
+      &values, &is_drain_scheduled));
+  EXPECT_TRUE(is_drain_scheduled);
+
+  const std::vector<std::pair<size_t, int64_t>> expected = {{1, 7}};
+  EXPECT_EQ(expected, Drain(&values));
+}
+
+}  // namespace brave
@@ -5,6 +5,7 @@
 
 #include "brave/components/p3a/brave_p3a_log_store.h"
 
+#include "base/containers/contains.h"
 #include "base/logging.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/rand_util.h"
@@ -34,11 +35,22 @@ void RecordP3A(uint64_t answers_count) {
   UMA_HISTOGRAM_EXACT_LINEAR("Brave.P3A.SentAnswersCount", answer, 3);
 }
 
+std::string GetLogType(base::StringPiece histogram_name) {
+  if (base::StartsWith(histogram_name, "Brave.P2A",
+                       base::CompareCase::SENSITIVE)) {
+    return "p2a";
+  }
+  return "p3a";
+}
+
 }  // namespace
 
 BraveP3ALogStore::BraveP3ALogStore(Delegate* delegate,
-                                   PrefService* local_state)
-    : delegate_(delegate), local_state_(local_state) {
+                                   PrefService* local_state,
+                                   bool batch_upload)
+    : delegate_(delegate),
+      local_state_(local_state),
+      batch_upload_(batch_upload) {
   DCHECK(delegate_);
   DCHECK(local_state);
 }
@@ -52,6 +64,7 @@ void BraveP3ALogStore::RegisterPrefs(PrefRegistrySimple* registry) {
 void BraveP3ALogStore::UpdateValue(const std::string& histogram_name,
                                    uint64_t value) {
   LogEntry& entry = log_[histogram_name];
+  const bool value_changed = entry.value != value;
   entry.value = value;
   if (!entry.sent) {
     DCHECK(entry.sent_timestamp.is_null());
@@ -63,6 +76,12 @@ void BraveP3ALogStore::UpdateValue(const std::string& histogram_name,
   update->SetPath({histogram_name, kLogValueKey},
                   base::Value(base::NumberToString(value)));
   update->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+
+  // The staged log would still contain the old value and be marked as sent
+  // once uploaded, so unstage it.
+  if (value_changed) {
+    UnstageLogIfContains(histogram_name);
+  }
 }
 
 void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
@@ -74,8 +93,15 @@ void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
   DictionaryPrefUpdate update(local_state_, kPrefName);
   update->RemovePath(histogram_name);
 
-  if (has_staged_log() && staged_entry_key_ == histogram_name) {
-    staged_entry_key_.clear();
+  // The staged log would still contain the removed value, so unstage it.
+  UnstageLogIfContains(histogram_name);
+}
+
+void BraveP3ALogStore::UnstageLogIfContains(
+    const std::string& histogram_name) {
+  // The unsent values are staged again on the next upload attempt.
+  if (base::Contains(staged_entry_keys_, histogram_name)) {
+    staged_entry_keys_.clear();
     staged_log_.clear();
   }
 }
@@ -111,27 +137,20 @@ bool BraveP3ALogStore::has_unsent_logs() const {
 }
 
 bool BraveP3ALogStore::has_staged_log() const {
-  return !staged_entry_key_.empty();
+  return !staged_entry_keys_.empty();
 }
 
 const std::string& BraveP3ALogStore::staged_log() const {
-  DCHECK(!staged_entry_key_.empty());
-  auto iter = log_.find(staged_entry_key_);
-  DCHECK(iter != log_.end());
+  DCHECK(has_staged_log());
 
   return staged_log_;
 }
 
 std::string BraveP3ALogStore::staged_log_type() const {
-  DCHECK(!staged_entry_key_.empty());
-  auto iter = log_.find(staged_entry_key_);
-  DCHECK(iter != log_.end());
+  DCHECK(has_staged_log());
 
-  if (base::StartsWith(iter->first, "Brave.P2A",
-                       base::CompareCase::SENSITIVE)) {
-    return "p2a";
-  }
-  return "p3a";
+  // All staged entries have the same type.
+  return GetLogType(staged_entry_keys_.front());
 }
 
 const std::string& BraveP3ALogStore::staged_log_hash() const {
@@ -153,13 +172,39 @@ void BraveP3ALogStore::StageNextLog() {
   // Stage the next item.
   DCHECK(has_unsent_logs());
   uint64_t rand_idx = base::RandGenerator(unsent_entries_.size());
-  staged_entry_key_ = *(unsent_entries_.begin() + rand_idx);
-  DCHECK(!log_.find(staged_entry_key_)->second.sent);
+  const std::string& staged_entry_key = *(unsent_entries_.begin() + rand_idx);
+  DCHECK(!log_.find(staged_entry_key)->second.sent);
+
+  if (!batch_upload_) {
+    staged_entry_keys_ = {staged_entry_key};
+    uint64_t staged_entry_value = log_[staged_entry_key].value;
+    staged_log_ = delegate_->Serialize(staged_entry_key, staged_entry_value);
 
-  uint64_t staged_entry_value = log_[staged_entry_key_].value;
-  staged_log_ = delegate_->Serialize(staged_entry_key_, staged_entry_value);
+    VLOG(2) << "BraveP3ALogStore::StageNextLog: staged " << staged_entry_key;
+    return;
+  }
+
+  // P3A and P2A values are uploaded to different endpoints, so the batch
+  // contains only the unsent values of the randomly picked entry type.
+  const std::string log_type = GetLogType(staged_entry_key);
+  staged_entry_keys_.clear();
+  for (const auto& key : unsent_entries_) {
+    if (GetLogType(key) == log_type) {
+      staged_entry_keys_.push_back(key);
+    }
+  }
+  // Don't let the order of values in the batch reveal anything.
+  base::RandomShuffle(staged_entry_keys_.begin(), staged_entry_keys_.end());
 
-  VLOG(2) << "BraveP3ALogStore::StageNextLog: staged " << staged_entry_key_;
+  std::vector<std::pair<std::string, uint64_t>> entries;
+  entries.reserve(staged_entry_keys_.size());
+  for (const auto& key : staged_entry_keys_) {
+    entries.emplace_back(key, log_[key].value);
+  }
+  staged_log_ = delegate_->SerializeBatch(entries);
+
+  VLOG(2) << "BraveP3ALogStore::StageNextLog: staged " << entries.size()
+          << " entries of type " << log_type;
 }
 
 void BraveP3ALogStore::DiscardStagedLog() {
@@ -167,24 +212,26 @@ void BraveP3ALogStore::DiscardStagedLog() {
     return;
   }
 
-  // Mark previous staged log as sent.
-  auto log_iter = log_.find(staged_entry_key_);
-  DCHECK(log_iter != log_.end());
-  log_iter->second.MarkAsSent();
-
-  // Update the persistent value.
   DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->SetPath({log_iter->first, kLogSentKey},
-                  base::Value(log_iter->second.sent));
-  update->SetPath({log_iter->first, kLogTimestampKey},
-                  base::Value(log_iter->second.sent_timestamp.ToDoubleT()));
-
-  // Erase the entry from the unsent queue.
-  auto unsent_entries_iter = unsent_entries_.find(staged_entry_key_);
-  DCHECK(unsent_entries_iter != unsent_entries_.end());
-  unsent_entries_.erase(unsent_entries_iter);
+  for (const auto& staged_entry_key : staged_entry_keys_) {
+    // Mark previous staged log as sent.
+    auto log_iter = log_.find(staged_entry_key);
+    DCHECK(log_iter != log_.end());
+    log_iter->second.MarkAsSent();
+
+    // Update the persistent value.
+    update->SetPath({log_iter->first, kLogSentKey},
+                    base::Value(log_iter->second.sent));
+    update->SetPath({log_iter->first, kLogTimestampKey},
+                    base::Value(log_iter->second.sent_timestamp.ToDoubleT()));
+
+    // Erase the entry from the unsent queue.
+    auto unsent_entries_iter = unsent_entries_.find(staged_entry_key);
+    DCHECK(unsent_entries_iter != unsent_entries_.end());
+    unsent_entries_.erase(unsent_entries_iter);
+  }
 
-  staged_entry_key_.clear();
+  staged_entry_keys_.clear();
   staged_log_.clear();
 }
 
@@ -7,6 +7,8 @@
 #define BRAVE_COMPONENTS_P3A_BRAVE_P3A_LOG_STORE_H_
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
@@ -31,18 +33,25 @@ class BraveP3ALogStore : public metrics::LogStore {
     // Prepares a string representaion of an entry.
     virtual std::string Serialize(base::StringPiece histogram_name,
                                   uint64_t value) = 0;
+    // Prepares a string representation of several entries uploaded at once.
+    virtual std::string SerializeBatch(
+        const std::vector<std::pair<std::string, uint64_t>>& entries) = 0;
     // Returns false if the metric is obsolete and should be cleaned up.
     virtual bool IsActualMetric(base::StringPiece histogram_name) const = 0;
     virtual ~Delegate() {}
   };
 
+  // In the batch upload mode all unsent values of the same type are staged
+  // together, in random order, instead of one value at a time.
   BraveP3ALogStore(Delegate* delegate,
-                   PrefService* local_state);
+                   PrefService* local_state,
+                   bool batch_upload);
 
   ~BraveP3ALogStore() override;
 
   static void RegisterPrefs(PrefRegistrySimple* registry);
 
+  // Updates the metric value and unstages it if it is staged.
   void UpdateValue(const std::string& histogram_name, uint64_t value);
   // Removes and also unstages the metric value if it is known and/or staged.
   void RemoveValueIfExists(const std::string& histogram_name);
@@ -85,6 +94,9 @@ class BraveP3ALogStore : public metrics::LogStore {
     base::Time sent_timestamp;  // At the moment only for debugging purposes.
   };
 
+  // Drops the staged log if it contains a value of the metric.
+  void UnstageLogIfContains(const std::string& histogram_name);
+
   Delegate* const delegate_ = nullptr;  // Weak.
   PrefService* const local_state_ = nullptr;
 
@@ -92,7 +104,10 @@ class BraveP3ALogStore : public metrics::LogStore {
   base::flat_map<std::string, LogEntry> log_;
   base::flat_set<std::string> unsent_entries_;
 
-  std::string staged_entry_key_;
+  const bool batch_upload_;
+
+  // Holds a single key unless |batch_upload_| is set.
+  std::vector<std::string> staged_entry_keys_;
   std::string staged_log_;
 
   // Not used for now.
@@ -0,0 +1,159 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_log_store.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "components/prefs/testing_pref_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveP3ALogStoreTest.*
+
+namespace brave {
+
+namespace {
+
+class TestDelegate : public BraveP3ALogStore::Delegate {
+ public:
+  std::string Serialize(base::StringPiece histogram_name,
+                        uint64_t value) override {
+    return std::string(histogram_name) + "=" + base::NumberToString(value);
+  }
+
+  std::string SerializeBatch(
+      const std::vector<std::pair<std::string, uint64_t>>& entries) override {
+    std::string log;
+    for (const auto& entry : entries) {
+      log += Serialize(entry.first, entry.second) + ";";
+    }
+    return log;
+  }
+
+  bool IsActualMetric(base::StringPiece histogram_name) const override {
+    return true;
+  }
+};
+
+}  // namespace
+
+class BraveP3ALogStoreTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    BraveP3ALogStore::RegisterPrefs(local_state_.registry());
+  }
+
+  std::unique_ptr<BraveP3ALogStore> CreateLogStore(bool batch_upload) {
+    auto log_store = std::make_unique<BraveP3ALogStore>(
+        &delegate_, &local_state_, batch_upload);
+    log_store->LoadPersistedUnsentLogs();
+    return log_store;
+  }
+
+  TestDelegate delegate_;
+  TestingPrefServiceSimple local_state_;
+};
+
+TEST_F(BraveP3ALogStoreTest, StageOneValue) {
+  auto log_store = CreateLogStore(/*batch_upload=*/false);
+  log_store->UpdateValue("Brave.Core.TabCount", 1);
+  log_store->UpdateValue("Brave.Core.WindowCount.2", 2);
+
+  log_store->StageNextLog();
+  EXPECT_TRUE(log_store->staged_log() == "Brave.Core.TabCount=1" ||
+              log_store->staged_log() == "Brave.Core.WindowCount.2=2");
+
+  log_store->DiscardStagedLog();
+  EXPECT_TRUE(log_store->has_unsent_logs());
+}
+
+TEST_F(BraveP3ALogStoreTest, StageBatchOfSameType) {
+  auto log_store = CreateLogStore(/*batch_upload=*/true);
+  log_store->UpdateValue("Brave.Core.TabCount", 1);
+  log_store->UpdateValue("Brave.Core.WindowCount.2", 2);
+  log_store->UpdateValue("Brave.P2A.TotalAdImpressions", 3);
+
+  // The P2A batch can be staged first since the type is picked randomly.
+  log_store->StageNextLog();
+  if (log_store->staged_log_type() == "p2a") {
+    EXPECT_EQ("Brave.P2A.TotalAdImpressions=3;", log_store->staged_log());
+    log_store->DiscardStagedLog();
+    log_store->StageNextLog();
+  }
+
+  ASSERT_EQ("p3a", log_store->staged_log_type());
+  const std::string& log = log_store->staged_log();
+  EXPECT_NE(std::string::npos, log.find("Brave.Core.TabCount=1;"));
+  EXPECT_NE(std::string::npos, log.find("Brave.Core.WindowCount.2=2;"));
+  EXPECT_EQ(std::string::npos, log.find("Brave.P2A"));
+
+  log_store->DiscardStagedLog();
+  if (log_store->has_unsent_logs()) {
+    log_store->StageNextLog();
+    EXPECT_EQ("Brave.P2A.TotalAdImpressions=3;", log_store->staged_log());
+    log_store->DiscardStagedLog();
+  }
+  EXPECT_FALSE(log_store->has_unsent_logs());
+}
+
+TEST_F(BraveP3ALogStoreTest, UnstageBatchWhenValueIsRemoved) {
+  auto log_store = CreateLogStore(/*batch_upload=*/true);
+  log_store->UpdateValue("Brave.Core.TabCount", 1);
+  log_store->UpdateValue("Brave.Core.WindowCount.2", 2);
+
+  log_store->StageNextLog();
+  log_store->RemoveValueIfExists("Brave.Core.TabCount");
+  EXPECT_FALSE(log_store->has_staged_log());
+
+  log_store->StageNextLog();
+  EXPECT_EQ("Brave.Core.WindowCount.2=2;", log_store->staged_log());
+}
+
+TEST_F(BraveP3ALogStoreTest, UnstageBatchWhenValueIsUpdated) {
+  auto log_store = CreateLogStore(/*batch_upload=*/true);
+  log_store->UpdateValue("Brave.Core.TabCount", 1);
+  log_store->UpdateValue("Brave.Core.WindowCount.2", 2);
+
+  log_store->StageNextLog();
+  log_store->UpdateValue("Brave.Core.TabCount", 3);
+  EXPECT_FALSE(log_store->has_staged_log());
+
+  log_store->StageNextLog();
+  const std::string& log = log_store->staged_log();
+  EXPECT_NE(std::string::npos, log.find("Brave.Core.TabCount=3;"));
+  EXPECT_EQ(std::string::npos, log.find("Brave.Core.TabCount=1;"));
+}
+
+TEST_F(BraveP3ALogStoreTest, KeepBatchWhenValueIsUnchanged) {
+  auto log_store = CreateLogStore(/*batch_upload=*/true);
+  log_store->UpdateValue("Brave.Core.TabCount", 1);
+  log_store->UpdateValue("Brave.Core.WindowCount.2", 2);
+
+  log_store->StageNextLog();
+  log_store->UpdateValue("Brave.Core.TabCount", 1);
+  EXPECT_TRUE(log_store->has_staged_log());
+
+  log_store->DiscardStagedLog();
+  EXPECT_FALSE(log_store->has_unsent_logs());
+}
+
+TEST_F(BraveP3ALogStoreTest, ResendBatchAfterRotation) {
+  auto log_store = CreateLogStore(/*batch_upload=*/true);
+  log_store->UpdateValue("Brave.Core.TabCount", 1);
+  log_store->UpdateValue("Brave.Core.WindowCount.2", 2);
+
+  log_store->StageNextLog();
+  log_store->DiscardStagedLog();
+  EXPECT_FALSE(log_store->has_unsent_logs());
+
+  log_store->ResetUploadStamps();
+  EXPECT_TRUE(log_store->has_unsent_logs());
+}
+
+}  // namespace brave
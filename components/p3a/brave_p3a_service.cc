@@ -10,16 +10,16 @@
 #include <utility>
 
 #include "base/command_line.h"
+#include "base/cxx17_backports.h"
 #include "base/i18n/timezone.h"
+#include "base/metrics/bucket_ranges.h"
+#include "base/metrics/histogram.h"
 #include "base/metrics/histogram_macros.h"
-#include "base/metrics/histogram_samples.h"
 #include "base/metrics/metrics_hashes.h"
-#include "base/metrics/sample_vector.h"
 #include "base/metrics/statistics_recorder.h"
 #include "base/no_destructor.h"
 #include "base/rand_util.h"
 #include "base/strings/string_number_conversions.h"
-#include "base/task/post_task.h"
 #include "base/trace_event/trace_event.h"
 #include "brave/components/brave_prochlo/prochlo_message.pb.h"
 #include "brave/components/brave_referrals/common/pref_names.h"
@@ -35,6 +35,7 @@
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/pref_service.h"
 #include "content/public/browser/browser_task_traits.h"
+#include "content/public/browser/browser_thread.h"
 #include "services/network/public/cpp/shared_url_loader_factory.h"
 #include "third_party/metrics_proto/reporting_info.pb.h"
 
@@ -45,7 +46,6 @@ namespace {
 // Receiving this value will effectively prevent the metric from transmission
 // to the backend. For now we consider this as a hack for p2a metrics, which
 // should be refactored in better times.
-constexpr int32_t kSuspendedMetricValue = INT_MAX - 1;
 constexpr uint64_t kSuspendedMetricBucket = INT_MAX - 1;
 
 constexpr char kLastRotationTimeStampPref[] = "p3a.last_rotation_timestamp";
@@ -54,6 +54,10 @@ constexpr char kP3AServerUrl[] = "https://p3a.brave.com/";
 constexpr char kP2AServerUrl[] = "https://p2a.brave.com/";
 
 constexpr uint64_t kDefaultUploadIntervalSeconds = 60;  // 1 minute.
+constexpr uint64_t kDefaultBatchUploadIntervalSeconds = 60 * 60;  // 1 hour.
+
+// Histogram changes received within this delay are handled together.
+constexpr base::TimeDelta kHistogramChangesDelay = base::Seconds(1);
 
 // TODO(iefremov): Provide moar histograms!
 // Whitelist for histograms that we collect. Will be replaced with something
@@ -203,12 +207,32 @@ base::Time NextMonday(base::Time time) {
 
 }  // namespace
 
+namespace internal {
+
+size_t GetBucketIndex(const base::BucketRanges& bucket_ranges,
+                      base::HistogramBase::Sample sample) {
+  size_t under = 0;
+  size_t over = bucket_ranges.bucket_count();
+  while (over - under > 1) {
+    const size_t mid = under + (over - under) / 2;
+    if (bucket_ranges.range(mid) <= sample) {
+      under = mid;
+    } else {
+      over = mid;
+    }
+  }
+  return under;
+}
+
+}  // namespace internal
+
 BraveP3AService::BraveP3AService(PrefService* local_state,
                                  std::string channel,
                                  std::string week_of_install)
     : local_state_(std::move(local_state)),
       channel_(std::move(channel)),
-      week_of_install_(week_of_install) {}
+      week_of_install_(week_of_install),
+      latest_samples_(base::size(kCollectedHistograms)) {}
 
 BraveP3AService::~BraveP3AService() = default;
 
@@ -223,12 +247,13 @@ void BraveP3AService::RegisterPrefs(PrefRegistrySimple* registry,
 }
 
 void BraveP3AService::InitCallbacks() {
-  for (const char* histogram_name : kCollectedHistograms) {
+  for (size_t i = 0; i < base::size(kCollectedHistograms); i++) {
     histogram_sample_callbacks_.push_back(
         std::make_unique<
             base::StatisticsRecorder::ScopedHistogramSampleObserver>(
-            histogram_name,
-            base::BindRepeating(&BraveP3AService::OnHistogramChanged, this)));
+            kCollectedHistograms[i],
+            base::BindRepeating(&BraveP3AService::OnHistogramChanged, this,
+                                i)));
   }
 }
 
@@ -246,19 +271,17 @@ void BraveP3AService::Init(
   VLOG(2) << "BraveP3AService parameters are:"
           << ", average_upload_interval_ = " << average_upload_interval_
           << ", randomize_upload_interval_ = " << randomize_upload_interval_
+          << ", batch_upload_ = " << batch_upload_
           << ", upload_server_url_ = " << upload_server_url_.spec()
           << ", rotation_interval_ = " << rotation_interval_;
 
   InitMessageMeta();
 
   // Init log store.
-  log_store_.reset(new BraveP3ALogStore(this, local_state_));
+  log_store_.reset(new BraveP3ALogStore(this, local_state_, batch_upload_));
   log_store_->LoadPersistedUnsentLogs();
   // Store values that were recorded between calling constructor and |Init()|.
-  for (const auto& entry : histogram_values_) {
-    HandleHistogramChange(std::string(entry.first), entry.second);
-  }
-  histogram_values_ = {};
+  HandleHistogramChanges();
   // Do rotation if needed.
   const base::Time last_rotation =
       local_state_->GetTime(kLastRotationTimeStampPref);
@@ -278,6 +301,7 @@ void BraveP3AService::Init(
   // Init other components.
   uploader_.reset(new BraveP3AUploader(
       url_loader_factory, upload_server_url_, GURL(kP2AServerUrl),
+      batch_upload_,
       base::BindRepeating(&BraveP3AService::OnLogUploadComplete, this)));
 
   upload_scheduler_.reset(new BraveP3AScheduler(
@@ -309,6 +333,17 @@ std::string BraveP3AService::Serialize(base::StringPiece histogram_name,
   return message.SerializeAsString();
 }
 
+std::string BraveP3AService::SerializeBatch(
+    const std::vector<std::pair<std::string, uint64_t>>& entries) {
+  UpdateMessageMeta();
+  brave_pyxis::RawP3AValueBatch batch;
+  for (const auto& entry : entries) {
+    GenerateP3AMessage(base::HashMetricName(entry.first), entry.second,
+                       message_meta_, batch.add_values());
+  }
+  return batch.SerializeAsString();
+}
+
 bool
 BraveP3AService::IsActualMetric(base::StringPiece histogram_name) const {
   static const base::NoDestructor<base::flat_set<base::StringPiece>>
@@ -320,6 +355,12 @@ BraveP3AService::IsActualMetric(base::StringPiece histogram_name) const {
 void BraveP3AService::MaybeOverrideSettingsFromCommandLine() {
   base::CommandLine* cmdline = base::CommandLine::ForCurrentProcess();
 
+  if (cmdline->HasSwitch(switches::kP3ABatchUpload)) {
+    batch_upload_ = true;
+    average_upload_interval_ =
+        base::Seconds(kDefaultBatchUploadIntervalSeconds);
+  }
+
   if (cmdline->HasSwitch(switches::kP3AUploadIntervalSeconds)) {
     std::string seconds_str =
         cmdline->GetSwitchValueASCII(switches::kP3AUploadIntervalSeconds);
@@ -410,46 +451,73 @@ void BraveP3AService::StartScheduledUpload() {
   }
 }
 
-void BraveP3AService::OnHistogramChanged(const char* histogram_name,
+void BraveP3AService::OnHistogramChanged(size_t histogram_index,
+                                         const char* histogram_name,
                                          uint64_t name_hash,
                                          base::HistogramBase::Sample sample) {
-  std::unique_ptr<base::HistogramSamples> samples =
-      base::StatisticsRecorder::FindHistogram(histogram_name)->SnapshotDelta();
-
-  // Stop now if there's nothing to do.
-  if (samples->Iterator()->Done())
+  // Only the latest sample matters, so the bucket is looked up on UI thread
+  // once the samples recorded in the meantime are drained.
+  if (!latest_samples_.Record(histogram_index, sample)) {
+    // A drain is already scheduled and will pick this sample up.
     return;
+  }
+
+  content::GetUIThreadTaskRunner({})->PostTask(
+      FROM_HERE,
+      base::BindOnce(&BraveP3AService::DrainLatestSamplesOnUI, this));
+}
 
-  // Shortcut for the special values, see |kSuspendedMetricValue|
+void BraveP3AService::DrainLatestSamplesOnUI() {
+  latest_samples_.Drain(
+      base::BindRepeating(&BraveP3AService::OnHistogramSampleOnUI, this));
+}
+
+void BraveP3AService::OnHistogramSampleOnUI(size_t histogram_index,
+                                            int64_t sample) {
+  const char* histogram_name = kCollectedHistograms[histogram_index];
+
+  // Shortcut for the special values, see |kSuspendedMetricBucket|
   // description for details.
   if (IsSuspendedMetric(histogram_name, sample)) {
-    base::PostTask(FROM_HERE, {content::BrowserThread::UI},
-                   base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI,
-                                  this,
-                                  histogram_name,
-                                  kSuspendedMetricValue,
-                                  kSuspendedMetricBucket));
+    OnHistogramChangedOnUI(histogram_index, kSuspendedMetricBucket);
     return;
   }
 
-  // Note that we store only buckets, not actual values.
-  size_t bucket = 0u;
-  const bool ok = samples->Iterator()->GetBucketIndex(&bucket);
-  if (!ok) {
-    LOG(ERROR) << "Only linear histograms are supported at the moment!";
+  base::HistogramBase* histogram =
+      base::StatisticsRecorder::FindHistogram(histogram_name);
+  if (!histogram) {
     NOTREACHED();
     return;
   }
 
+  // Only these types are |base::Histogram|s with bucket ranges.
+  switch (histogram->GetHistogramType()) {
+    case base::HISTOGRAM:
+    case base::LINEAR_HISTOGRAM:
+    case base::BOOLEAN_HISTOGRAM:
+    case base::CUSTOM_HISTOGRAM:
+      break;
+    case base::SPARSE_HISTOGRAM:
+      LOG(ERROR) << "Only linear histograms are supported at the moment!";
+      NOTREACHED();
+      return;
+    default:
+      // E.g. a |DUMMY_HISTOGRAM| for an expired histogram has no buckets.
+      return;
+  }
+
+  // Note that we store only buckets, not actual values.
+  const base::BucketRanges* bucket_ranges =
+      static_cast<base::Histogram*>(histogram)->bucket_ranges();
+  size_t bucket = internal::GetBucketIndex(
+      *bucket_ranges, static_cast<base::HistogramBase::Sample>(sample));
+
   // Special handling of P2A histograms.
   if (base::StartsWith(histogram_name, "Brave.P2A.",
                        base::CompareCase::SENSITIVE)) {
     // We need the bucket count to make proper perturbation.
     // All P2A metrics should be implemented as linear histograms.
-    base::SampleVector* vector =
-        static_cast<base::SampleVector*>(samples.get());
-    DCHECK(vector);
-    const size_t bucket_count = vector->bucket_ranges()->bucket_count() - 1;
+    const size_t bucket_count = bucket_ranges->bucket_count() - 1;
     VLOG(2) << "P2A metric " << histogram_name << " has bucket count "
             << bucket_count;
 
@@ -457,22 +525,39 @@ void BraveP3AService::OnHistogramChanged(const char* histogram_name,
     bucket = DirectEncodingProtocol::Perturb(bucket_count, bucket);
   }
 
-  base::PostTask(FROM_HERE, {content::BrowserThread::UI},
-                 base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI, this,
-                                histogram_name, sample, bucket));
+  OnHistogramChangedOnUI(histogram_index, bucket);
 }
 
-void BraveP3AService::OnHistogramChangedOnUI(const char* histogram_name,
-                                             base::HistogramBase::Sample sample,
-                                             size_t bucket) {
+void BraveP3AService::OnHistogramChangedOnUI(size_t histogram_index,
+                                             int64_t bucket) {
+  const char* histogram_name = kCollectedHistograms[histogram_index];
   VLOG(2) << "BraveP3AService::OnHistogramChanged: histogram_name = "
-          << histogram_name << " Sample = " << sample << " bucket = " << bucket;
+          << histogram_name << " bucket = " << bucket;
+  // Only the latest bucket of each histogram is kept until the changes are
+  // handled.
+  histogram_values_[histogram_name] = bucket;
   if (!initialized_) {
     // Will handle it later when ready.
-    histogram_values_[histogram_name] = bucket;
-  } else {
-    HandleHistogramChange(histogram_name, bucket);
+    return;
   }
+
+  if (histogram_changes_scheduled_) {
+    return;
+  }
+
+  histogram_changes_scheduled_ = true;
+  content::GetUIThreadTaskRunner({})->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&BraveP3AService::HandleHistogramChanges, this),
+      kHistogramChangesDelay);
+}
+
+void BraveP3AService::HandleHistogramChanges() {
+  histogram_changes_scheduled_ = false;
+  for (const auto& entry : histogram_values_) {
+    HandleHistogramChange(entry.first, entry.second);
+  }
+  histogram_values_ = {};
 }
 
 void BraveP3AService::HandleHistogramChange(base::StringPiece histogram_name,
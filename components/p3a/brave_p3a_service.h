@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/containers/flat_map.h"
@@ -15,12 +16,17 @@
 #include "base/metrics/histogram_base.h"
 #include "base/metrics/statistics_recorder.h"
 #include "base/timer/wall_clock_timer.h"
+#include "brave/components/p3a/brave_p3a_latest_values.h"
 #include "brave/components/p3a/brave_p3a_log_store.h"
 #include "brave/components/p3a/p3a_message.h"
 #include "url/gurl.h"
 
 class PrefRegistrySimple;
 
+namespace base {
+class BucketRanges;
+}
+
 namespace network {
 class SharedURLLoaderFactory;
 }
@@ -30,6 +36,14 @@ namespace brave {
 class BraveP3AScheduler;
 class BraveP3AUploader;
 
+namespace internal {
+
+// Finds the bucket containing the sample the same way |SampleVector| does.
+size_t GetBucketIndex(const base::BucketRanges& bucket_ranges,
+                      base::HistogramBase::Sample sample);
+
+}  // namespace internal
+
 // Core class for Brave Privacy-Preserving Product Analytics machinery.
 // Works on UI thread. Refcounted to receive histogram updating callbacks
 // on any thread.
@@ -54,6 +68,8 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   // BraveP3ALogStore::Delegate
   std::string Serialize(base::StringPiece histogram_name,
                         uint64_t value) override;
+  std::string SerializeBatch(
+      const std::vector<std::pair<std::string, uint64_t>>& entries) override;
 
   // May be accessed from multiple threads, so this is thread-safe.
   bool IsActualMetric(base::StringPiece histogram_name) const override;
@@ -73,13 +89,20 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
 
   // Invoked by callbacks registered by our service. Since these callbacks
   // can fire on any thread, this method reposts everything to UI thread.
-  void OnHistogramChanged(const char* histogram_name,
+  void OnHistogramChanged(size_t histogram_index,
+                          const char* histogram_name,
                           uint64_t name_hash,
                           base::HistogramBase::Sample sample);
 
-  void OnHistogramChangedOnUI(const char* histogram_name,
-                              base::HistogramBase::Sample sample,
-                              size_t bucket);
+  void DrainLatestSamplesOnUI();
+
+  // Finds the bucket of the latest sample of the histogram.
+  void OnHistogramSampleOnUI(size_t histogram_index, int64_t sample);
+
+  void OnHistogramChangedOnUI(size_t histogram_index, int64_t bucket);
+
+  // Handles the histogram changes received since the last call together.
+  void HandleHistogramChanges();
 
   // Updates or removes a metric from the log.
   void HandleHistogramChange(base::StringPiece histogram_name, size_t bucket);
@@ -101,6 +124,8 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   // The average interval between uploading different values.
   base::TimeDelta average_upload_interval_;
   bool randomize_upload_interval_ = true;
+  // Upload all unsent values of the same type at once.
+  bool batch_upload_ = false;
   // Interval between rotations, only used for testing from the command line.
   base::TimeDelta rotation_interval_;
   GURL upload_server_url_;
@@ -112,9 +137,15 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   std::unique_ptr<BraveP3AUploader> uploader_;
   std::unique_ptr<BraveP3AScheduler> upload_scheduler_;
 
-  // Used to store histogram values that are produced between constructing
-  // the service and its initialization.
+  // Used to store histogram values that are not handled yet: those produced
+  // between constructing the service and its initialization, and those
+  // waiting for the next |HandleHistogramChanges()| call.
   base::flat_map<base::StringPiece, size_t> histogram_values_;
+  bool histogram_changes_scheduled_ = false;
+
+  // Latest samples of the histograms changed since the last
+  // |DrainLatestSamplesOnUI()| call, indexed as |kCollectedHistograms|.
+  BraveP3ALatestValues latest_samples_;
 
   // Once fired we restart the overall uploading process.
   base::WallClockTimer rotation_timer_;
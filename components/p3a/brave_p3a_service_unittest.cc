@@ -0,0 +1,65 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_service.h"
+
+#include <memory>
+
+#include "base/metrics/histogram.h"
+#include "base/metrics/histogram_samples.h"
+#include "base/metrics/statistics_recorder.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveP3AServiceTest.*
+
+namespace brave {
+
+namespace {
+
+// Compares the bucket found for every sample in [min, max] with the one
+// |SampleVector| puts the sample into.
+void ExpectBucketIndexMatchesSampleVector(base::HistogramBase* histogram,
+                                          base::HistogramBase::Sample min,
+                                          base::HistogramBase::Sample max) {
+  const base::BucketRanges* bucket_ranges =
+      static_cast<base::Histogram*>(histogram)->bucket_ranges();
+  for (base::HistogramBase::Sample sample = min; sample <= max; sample++) {
+    histogram->Add(sample);
+    std::unique_ptr<base::HistogramSamples> samples =
+        histogram->SnapshotDelta();
+
+    size_t expected_bucket = 0u;
+    ASSERT_TRUE(samples->Iterator()->GetBucketIndex(&expected_bucket));
+    EXPECT_EQ(expected_bucket, internal::GetBucketIndex(*bucket_ranges, sample))
+        << "sample = " << sample;
+  }
+}
+
+}  // namespace
+
+class BraveP3AServiceTest : public testing::Test {
+ protected:
+  std::unique_ptr<base::StatisticsRecorder> statistics_recorder_ =
+      base::StatisticsRecorder::CreateTemporaryForTesting();
+};
+
+TEST_F(BraveP3AServiceTest, GetBucketIndexForLinearHistogram) {
+  // Same layout as |UmaHistogramExactLinear()| with an exclusive max of 8.
+  base::HistogramBase* histogram = base::LinearHistogram::FactoryGet(
+      "Brave.Test.Linear", 1, 8, 9,
+      base::HistogramBase::kUmaTargetedHistogramFlag);
+  ExpectBucketIndexMatchesSampleVector(histogram, 0, 10);
+}
+
+TEST_F(BraveP3AServiceTest, GetBucketIndexForP2AHistogram) {
+  // P2A metrics are recorded with |UmaHistogramExactLinear()| as well, with
+  // the bucket count passed as the exclusive max.
+  base::HistogramBase* histogram = base::LinearHistogram::FactoryGet(
+      "Brave.P2A.Test", 1, 7, 8,
+      base::HistogramBase::kUmaTargetedHistogramFlag);
+  ExpectBucketIndexMatchesSampleVector(histogram, 0, 9);
+}
+
+}  // namespace brave
@@ -22,6 +22,10 @@ constexpr char kP3ARotationIntervalSeconds[] = "p3a-rotation-interval-seconds";
 // P3A cloud backend URL.
 constexpr char kP3AUploadServerUrl[] = "p3a-upload-server-url";
 
+// Upload all unsent values of the same type with a single request instead of
+// one request per value.
+constexpr char kP3ABatchUpload[] = "p3a-batch-upload";
+
 // Do not try to resent values even if a cloud returned an HTTP error, just
 // continue the normal process.
 constexpr char kP3AIgnoreServerErrors[] = "p3a-ignore-server-errors";
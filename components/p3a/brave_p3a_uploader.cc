@@ -73,10 +73,12 @@ BraveP3AUploader::BraveP3AUploader(
     scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
     const GURL& p3a_endpoint,
     const GURL& p2a_endpoint,
+    bool batch_upload,
     const UploadCallback& on_upload_complete)
     : url_loader_factory_(url_loader_factory),
       p3a_endpoint_(p3a_endpoint),
       p2a_endpoint_(p2a_endpoint),
+      batch_upload_(batch_upload),
       on_upload_complete_(on_upload_complete) {}
 
 BraveP3AUploader::~BraveP3AUploader() = default;
@@ -93,6 +95,10 @@ void BraveP3AUploader::UploadLog(const std::string& compressed_log_data,
   } else {
     NOTREACHED();
   }
+  if (batch_upload_) {
+    // The body is a serialized RawP3AValueBatch.
+    resource_request->headers.SetHeader("X-Brave-Batch", "?1");
+  }
 
   resource_request->credentials_mode = network::mojom::CredentialsMode::kOmit;
   resource_request->method = "POST";
@@ -28,6 +28,7 @@ class BraveP3AUploader {
       scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
       const GURL& p3a_endpoint,
       const GURL& p2a_endpoint,
+      bool batch_upload,
       const UploadCallback& on_upload_complete);
 
   ~BraveP3AUploader();
@@ -42,6 +43,7 @@ class BraveP3AUploader {
   scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
   const GURL p3a_endpoint_;
   const GURL p2a_endpoint_;
+  const bool batch_upload_;
   const UploadCallback on_upload_complete_;
   std::unique_ptr<network::SimpleURLLoader> url_loader_;
   DISALLOW_COPY_AND_ASSIGN(BraveP3AUploader);